@@ -0,0 +1,85 @@
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include <cstdlib>
+
+// Steady-state allocation check for CI. Counts the heap allocations of the per-record
+// loops once they are warm (scratch arenas sized, term table already holding every word):
+//  - predict over every test tweet must allocate nothing at all;
+//  - a second train() over the same file, and an evaluate() run, may only allocate a fixed
+//    per-call amount (buffers, thread pool, output streams) that does not grow with the
+//    number of records.
+// Exits with status 1 if either budget is exceeded.
+//
+// Usage: sentiment_bench allocations [training.csv] [tests.csv] [sentiment.csv]
+//        (defaults: the bundled 20k/10k datasets)
+
+// Allocations a whole train() or evaluate() call may make regardless of its input size.
+static const unsigned long long PER_CALL_BUDGET = 64;
+
+// Prints one measurement with its allocation count and whether it is within 'budget'.
+static bool reportAllocations(const char* bench, unsigned long long records, double seconds,
+                              unsigned long long allocations, unsigned long long budget) {
+    bool ok = allocations <= budget;
+    printf("bench=%s size=%llu seconds=%.6f allocations=%llu allocations_per_record=%.6f budget=%llu status=%s\n",
+           bench, records, seconds, allocations, records > 0 ? (double)allocations / records : 0.0,
+           budget, ok ? "ok" : "FAILED");
+    fflush(stdout);
+    return ok;
+}
+
+int runAllocationBench(int argc, char* argv[]) {
+    std::string trainingFile = (argc > 0) ? argv[0] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 1) ? argv[1] : dataFile("test_dataset_10k.csv");
+    std::string sentimentFile = (argc > 2) ? argv[2] : dataFile("test_dataset_sentiment_10k.csv");
+
+    // Tweet texts of the test file, as views into the mapping.
+    MappedFile tests(testFile.c_str());
+    std::vector<DSStringView> tweets;
+    {
+        DSStringView contents = tests.view();
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 5) {
+                tweets.push_back(fields[4]);
+            }
+        }
+    }
+
+    SentimentClassifier classifier;
+    classifier.train(trainingFile.c_str());
+    unsigned long long records = classifier.trainingProgress().records;
+    bool ok = true;
+
+    // predict: one warm-up pass sizes this thread's scratch space, the second must not allocate.
+    int positives = 0;
+    for (size_t i = 0; i < tweets.size(); i++) {
+        positives += classifier.predict(tweets[i]);
+    }
+    unsigned long long before = allocationCount();
+    BenchTimer timer;
+    for (size_t i = 0; i < tweets.size(); i++) {
+        positives += classifier.predict(tweets[i]);
+    }
+    doNotOptimize(positives);
+    ok = reportAllocations("allocations.predict", tweets.size(), timer.seconds(), allocationCount() - before, 0) && ok;
+
+    // train: counting the same file again only updates existing terms.
+    before = allocationCount();
+    timer.restart();
+    classifier.train(trainingFile.c_str());
+    ok = reportAllocations("allocations.train", records, timer.seconds(), allocationCount() - before, PER_CALL_BUDGET) && ok;
+
+    // evaluate: ground truth, scoring on the pool and output; the results are discarded.
+    before = allocationCount();
+    timer.restart();
+    classifier.evaluate(testFile.c_str(), sentimentFile.c_str(), "/dev/null", "/dev/null");
+    ok = reportAllocations("allocations.evaluate", tweets.size(), timer.seconds(), allocationCount() - before, PER_CALL_BUDGET) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacement global allocation operators that count every call before forwarding to malloc.
+static std::atomic<unsigned long long> allocations(0);
+static std::atomic<unsigned long long> bytes(0);
+
+static void* countedAllocate(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+unsigned long long allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+unsigned long long allocatedBytes() {
+    return bytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,13 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// Counts heap allocations made through operator new / new[] in the sentiment_bench
+// process (AllocationCounter.cpp replaces the global allocation operators).
+
+// Number of allocations since the program started.
+unsigned long long allocationCount();
+
+// Number of bytes requested by those allocations.
+unsigned long long allocatedBytes();
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,90 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Shared helpers for the sentiment_bench executable.
+// Every benchmark prints one line per measurement as space-separated key=value
+// pairs, so the output can be grepped or parsed by scripts.
+
+// Wall-clock stopwatch.
+class BenchTimer {
+private:
+    std::chrono::steady_clock::time_point start;
+public:
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+    void restart() { start = std::chrono::steady_clock::now(); }
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Prints one measurement: bench=<name> impl=<impl> size=<n> ops=<ops> seconds=<s> mops_per_s=<ops/s/1e6>.
+inline void reportResult(const char* bench, const char* impl, unsigned long long size,
+                         unsigned long long ops, double seconds) {
+    double mops = (seconds > 0.0) ? ops / seconds / 1e6 : 0.0;
+    printf("bench=%s impl=%s size=%llu ops=%llu seconds=%.6f mops_per_s=%.3f\n",
+           bench, impl, size, ops, seconds, mops);
+    fflush(stdout);
+}
+
+// Latencies of individual operations, in nanoseconds, for percentile reports.
+class LatencySamples {
+private:
+    std::vector<double> nanos;
+    bool sorted;
+public:
+    LatencySamples() : sorted(true) {}
+    void reserve(size_t n) { nanos.reserve(n); }
+    void add(double ns) { nanos.push_back(ns); sorted = false; }
+    size_t count() const { return nanos.size(); }
+
+    // The p-th percentile (0 <= p <= 100, nearest rank); 0 if there are no samples.
+    double percentile(double p) {
+        if (nanos.empty()) {
+            return 0.0;
+        }
+        if (!sorted) {
+            std::sort(nanos.begin(), nanos.end());
+            sorted = true;
+        }
+        size_t rank = (size_t)(p / 100.0 * (nanos.size() - 1) + 0.5);
+        return nanos[rank];
+    }
+};
+
+// Keeps the optimizer from deleting a computation whose result is otherwise unused.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Path of a file in the bundled data directory (build/data).
+inline std::string dataFile(const char* name) {
+    return std::string(SENTIMENT_DATA_DIR) + "/" + name;
+}
+
+// Benchmark entry points (one per bench/*.cpp). Each receives the arguments after its name.
+int runHashMapBench(int argc, char* argv[]);
+int runPredictConcurrentBench(int argc, char* argv[]);
+int runNormalizerBench(int argc, char* argv[]);
+int runDSStringBench(int argc, char* argv[]);
+int runAllocationBench(int argc, char* argv[]);
+int runCsvBench(int argc, char* argv[]);
+int runScanBench(int argc, char* argv[]);
+int runStopWordBench(int argc, char* argv[]);
+int runStemmerBench(int argc, char* argv[]);
+int runTokenCacheBench(int argc, char* argv[]);
+int runJoinBench(int argc, char* argv[]);
+int runWriterBench(int argc, char* argv[]);
+int runLoadGenBench(int argc, char* argv[]);
+int runClassifyBench(int argc, char* argv[]);
+int runUpdateBench(int argc, char* argv[]);
+int runModelBench(int argc, char* argv[]);
+int runSuiteBench(int argc, char* argv[]);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include "StreamClassifier.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+// Throughput of `sentiment classify` (StreamClassifier) on a pipe: a feeder thread writes
+// the test file 'rounds' times into the pipe, the classifier reads it and writes to
+// /dev/null. The time of predict over the same tweets is printed alongside as the
+// ceiling. Also a parity check: classifying the test file once must give exactly one
+// "label,id" line per test tweet with predict's label. Exits with status 1 otherwise.
+//
+// Usage: sentiment_bench classify [rounds] [training.csv] [tests.csv]
+//        (defaults: 20, the bundled 20k/10k datasets)
+
+// Writes 'rounds' copies of data[0 .. length) to fd, then closes it.
+static void feed(int fd, const char* data, size_t length, int rounds) {
+    for (int r = 0; r < rounds; r++) {
+        size_t offset = 0;
+        while (offset < length) {
+            ssize_t written = write(fd, data + offset, length - offset);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                close(fd);
+                return;
+            }
+            offset += (size_t)written;
+        }
+    }
+    close(fd);
+}
+
+// Runs the classifier on 'rounds' copies of the file through a pipe, writing to outputFd.
+static bool classifyThroughPipe(StreamClassifier& stream, const DSStringView& contents, int rounds, int outputFd) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    std::thread feeder(feed, fds[1], contents.data(), contents.length(), rounds);
+    bool ok = stream.run(fds[0], outputFd);
+    feeder.join();
+    close(fds[0]);
+    return ok;
+}
+
+int runClassifyBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 20;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 2) ? argv[2] : dataFile("test_dataset_10k.csv");
+
+    SentimentClassifier classifier;
+    classifier.train(trainingFile.c_str());
+    MappedFile file(testFile.c_str());
+    DSStringView contents = file.view();
+
+    // The expected output, from predict.
+    std::ostringstream expected;
+    std::vector<DSStringView> texts;
+    {
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 5) {
+                expected << classifier.predict(fields[4]) << ',' << fields[0] << '\n';
+                texts.push_back(fields[4]);
+            }
+        }
+    }
+
+    // Parity: one pass into a temporary file.
+    StreamClassifier stream(classifier, StreamClassifier::INPUT_CSV, false);
+    char name[] = "/tmp/sentiment_classify_XXXXXX";
+    int outputFd = mkstemp(name);
+    bool same = outputFd >= 0 && classifyThroughPipe(stream, contents, 1, outputFd);
+    if (outputFd >= 0) {
+        close(outputFd);
+        std::ifstream in(name, std::ios::binary);
+        std::string actual((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        same = same && actual == expected.str();
+        unlink(name);
+    }
+
+    // Throughput through a pipe, against predict alone.
+    BenchTimer timer;
+    size_t positives = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < texts.size(); i++) {
+            positives += (size_t)classifier.predict(texts[i]);
+        }
+    }
+    doNotOptimize(positives);
+    double seconds = timer.seconds();
+    unsigned long long tweets = (unsigned long long)texts.size() * rounds;
+    printf("bench=classify.stream impl=predict_only tweets=%llu seconds=%.6f tweets_per_s=%.1f\n", tweets, seconds,
+           seconds > 0.0 ? tweets / seconds : 0.0);
+
+    int devNull = open("/dev/null", O_WRONLY);
+    timer.restart();
+    bool ok = devNull >= 0 && classifyThroughPipe(stream, contents, rounds, devNull);
+    seconds = timer.seconds();
+    if (devNull >= 0) {
+        close(devNull);
+    }
+    double megabytes = (double)contents.length() * rounds / 1e6;
+    printf("bench=classify.stream impl=pipe tweets=%llu seconds=%.6f tweets_per_s=%.1f mb_per_s=%.1f\n",
+           stream.classifiedCount(), seconds, seconds > 0.0 ? stream.classifiedCount() / seconds : 0.0,
+           seconds > 0.0 ? megabytes / seconds : 0.0);
+
+    ok = ok && same && stream.classifiedCount() == tweets;
+    printf("bench=classify.check same=%s status=%s\n", same ? "yes" : "no", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
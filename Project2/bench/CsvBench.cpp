@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "Tokenizer.h"
+#include <cstdlib>
+#include <cstring>
+
+// Records per second of CsvRecord::parse against splitting on every comma with
+// Tokenizer::tokenize, on the lines of a CSV file, plus a check: on every line without
+// a double quote both must produce the same fields. Exits with status 1 on any difference.
+//
+// Usage: sentiment_bench csv [rounds] [file.csv]   (defaults: 20, the bundled 20k training set)
+
+int runCsvBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 20;
+    std::string csvFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    MappedFile file(csvFile.c_str());
+    DSStringView contents = file.view();
+    std::vector<DSStringView> lines;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        lines.push_back(line);
+    }
+
+    std::vector<DSStringView> tokens;
+    CsvRecord record;
+    size_t mismatches = 0;
+    size_t quotedLines = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        record.parse(lines[i]);
+        if (memchr(lines[i].data(), '"', lines[i].length()) != nullptr) {
+            quotedLines++;        // Comma splitting is wrong for these; nothing to compare.
+            continue;
+        }
+        Tokenizer::tokenize(lines[i], ',', tokens);
+        bool same = tokens.size() == record.size();
+        for (size_t j = 0; same && j < tokens.size(); j++) {
+            same = tokens[j] == record[j];
+        }
+        if (!same) {
+            mismatches++;
+        }
+    }
+
+    BenchTimer timer;
+    size_t fields = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < lines.size(); i++) {
+            Tokenizer::tokenize(lines[i], ',', tokens);
+            fields += tokens.size();
+        }
+    }
+    doNotOptimize(fields);
+    reportResult("csv.records", "tokenize", lines.size(), (unsigned long long)lines.size() * rounds, timer.seconds());
+
+    timer.restart();
+    fields = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < lines.size(); i++) {
+            record.parse(lines[i]);
+            fields += record.size();
+        }
+    }
+    doNotOptimize(fields);
+    reportResult("csv.records", "CsvRecord", lines.size(), (unsigned long long)lines.size() * rounds, timer.seconds());
+
+    printf("bench=csv.check quoted_lines=%zu mismatches=%zu status=%s\n", quotedLines, mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return (mismatches == 0) ? 0 : 1;
+}
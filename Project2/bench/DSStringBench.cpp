@@ -0,0 +1,91 @@
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "DSString.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include "TextProcessor.h"
+#include "Tokenizer.h"
+#include <cstdlib>
+
+// DSString costs on real tweets: time and heap allocations for building strings one
+// character at a time, splitting, and the full chained TextProcessor pipeline, plus the
+// allocations of a complete training run.
+//
+// Usage: sentiment_bench dsstring [training.csv]   (default: the bundled 20k set)
+
+// Prints one measurement together with the heap allocations it made.
+static void reportWithAllocations(const char* bench, unsigned long long size, unsigned long long ops,
+                                  double seconds, unsigned long long allocations) {
+    double mops = (seconds > 0.0) ? ops / seconds / 1e6 : 0.0;
+    printf("bench=%s impl=DSString size=%llu ops=%llu seconds=%.6f mops_per_s=%.3f allocations=%llu allocations_per_op=%.3f\n",
+           bench, size, ops, seconds, mops, allocations, ops > 0 ? (double)allocations / ops : 0.0);
+    fflush(stdout);
+}
+
+int runDSStringBench(int argc, char* argv[]) {
+    std::string trainingFile = (argc > 0) ? argv[0] : dataFile("train_dataset_20k.csv");
+
+    // Tweet texts (sixth field) of the training file.
+    std::vector<DSString> tweets;
+    {
+        MappedFile file(trainingFile.c_str());
+        DSStringView contents = file.view();
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 6) {
+                tweets.push_back(fields[5].toDSString());
+            }
+        }
+    }
+
+    // Building every tweet one character at a time with append().
+    unsigned long long before = allocationCount();
+    BenchTimer timer;
+    unsigned long long chars = 0;
+    for (size_t i = 0; i < tweets.size(); i++) {
+        DSString copy;
+        const char* text = tweets[i].c_str();
+        for (size_t j = 0; j < tweets[i].length(); j++) {
+            copy.append(text[j]);
+        }
+        chars += copy.length();
+    }
+    reportWithAllocations("dsstring.append", tweets.size(), chars, timer.seconds(), allocationCount() - before);
+
+    // Splitting every tweet into words.
+    before = allocationCount();
+    timer.restart();
+    unsigned long long words = 0;
+    for (size_t i = 0; i < tweets.size(); i++) {
+        words += Tokenizer::tokenize(tweets[i], ' ').size();
+    }
+    reportWithAllocations("dsstring.tokenize", tweets.size(), words, timer.seconds(), allocationCount() - before);
+
+    // The chained pipeline: lowercase, strip punctuation, split, drop stop words, stem.
+    before = allocationCount();
+    timer.restart();
+    for (size_t i = 0; i < tweets.size(); i++) {
+        DSString cleaned = TextProcessor::removePunctuation(TextProcessor::toLower(tweets[i]));
+        std::vector<DSString> tokens = TextProcessor::removeStopWords(Tokenizer::tokenize(cleaned, ' '));
+        for (size_t j = 0; j < tokens.size(); j++) {
+            DSString stemmed = TextProcessor::stem(tokens[j]);
+            doNotOptimize(stemmed);
+        }
+    }
+    reportWithAllocations("dsstring.pipeline", tweets.size(), tweets.size(), timer.seconds(), allocationCount() - before);
+
+    // A complete training run on the file.
+    before = allocationCount();
+    timer.restart();
+    {
+        SentimentClassifier classifier;
+        classifier.train(trainingFile.c_str());
+    }
+    reportWithAllocations("dsstring.train", tweets.size(), tweets.size(), timer.seconds(), allocationCount() - before);
+    return 0;
+}
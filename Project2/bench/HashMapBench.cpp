@@ -0,0 +1,105 @@
+#include "Benchmark.h"
+#include "DSString.h"
+#include "StringHashMap.h"
+#include <cstdlib>
+#include <map>
+
+// Insert and lookup throughput of StringHashMap<int> against std::map<DSString, int>
+// (the classifier's previous frequency table) at vocabulary sizes typical for tweets.
+//
+// Usage: sentiment_bench hashmap [terms ...]   (default: 100000 1000000 5000000)
+
+// Deterministic xorshift generator so every run uses the same keys.
+static unsigned long long nextRandom(unsigned long long& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Builds 'count' pseudo-random lowercase terms of 3 to 12 letters.
+static std::vector<DSString> makeTerms(size_t count) {
+    std::vector<DSString> terms;
+    terms.reserve(count);
+    unsigned long long state = 0x2545F4914F6CDD1Dull;
+    char buffer[16];
+    for (size_t i = 0; i < count; i++) {
+        size_t length = 3 + nextRandom(state) % 10;
+        for (size_t j = 0; j < length; j++) {
+            buffer[j] = (char)('a' + nextRandom(state) % 26);
+        }
+        terms.push_back(DSString(buffer, length));
+    }
+    return terms;
+}
+
+// A shuffled order of 0..count-1, so lookups do not follow insertion order.
+static std::vector<size_t> makeLookupOrder(size_t count) {
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    unsigned long long state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = count; i > 1; i--) {
+        size_t j = nextRandom(state) % i;
+        size_t tmp = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = tmp;
+    }
+    return order;
+}
+
+static void benchSize(size_t terms) {
+    std::vector<DSString> keys = makeTerms(terms);
+    std::vector<size_t> order = makeLookupOrder(terms);
+
+    {
+        BenchTimer timer;
+        std::map<DSString, int> map;
+        for (size_t i = 0; i < keys.size(); i++) {
+            map[keys[i]]++;
+        }
+        reportResult("hashmap.insert", "std_map", terms, terms, timer.seconds());
+
+        timer.restart();
+        long long sum = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            sum += map.find(keys[order[i]])->second;
+        }
+        doNotOptimize(sum);
+        reportResult("hashmap.lookup", "std_map", terms, terms, timer.seconds());
+    }
+
+    {
+        BenchTimer timer;
+        StringHashMap<int> map;
+        for (size_t i = 0; i < keys.size(); i++) {
+            map[keys[i]]++;
+        }
+        reportResult("hashmap.insert", "StringHashMap", terms, terms, timer.seconds());
+
+        timer.restart();
+        long long sum = 0;
+        for (size_t i = 0; i < order.size(); i++) {
+            sum += *map.find(keys[order[i]]);
+        }
+        doNotOptimize(sum);
+        reportResult("hashmap.lookup", "StringHashMap", terms, terms, timer.seconds());
+    }
+}
+
+int runHashMapBench(int argc, char* argv[]) {
+    std::vector<size_t> sizes;
+    for (int i = 0; i < argc; i++) {
+        sizes.push_back((size_t)strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(100000);
+        sizes.push_back(1000000);
+        sizes.push_back(5000000);
+    }
+    for (size_t i = 0; i < sizes.size(); i++) {
+        benchSize(sizes[i]);
+    }
+    return 0;
+}
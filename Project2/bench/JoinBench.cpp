@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "GroundTruth.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include "StringHashMap.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+// Ground-truth join of the test tweets: lookups per second of the string hash map the
+// join used before (keyed by the ID field's text) against GroundTruthTable (integer IDs
+// in a flat table), then evaluate against evaluateSorted on copies of the test and
+// ground-truth files sorted by ID. Fails (exit status 1) if the table and the string map
+// disagree on any test ID, or if the two evaluate modes write different accuracy files.
+//
+// Usage: sentiment_bench join [rounds] [training.csv] [tests.csv] [sentiment.csv]
+//        (defaults: 5, the bundled 20k/10k datasets)
+
+// One input line and the ID it is sorted by.
+struct IdLine {
+    TweetId id;
+    DSStringView line;
+    bool operator<(const IdLine& other) const { return id < other.id; }
+};
+
+// Writes the lines of a CSV file, stably sorted by the ID in 'column', to a new
+// temporary file and returns its name (empty if it could not be created).
+static std::string writeSortedCopy(const char* fileName, size_t column) {
+    MappedFile file(fileName);
+    DSStringView contents = file.view();
+    std::vector<IdLine> lines;
+    CsvRecord fields;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        IdLine entry;
+        entry.id = TweetId::parse(fields.size() > column ? fields[column] : DSStringView());
+        entry.line = line;
+        lines.push_back(entry);
+    }
+    std::stable_sort(lines.begin(), lines.end());
+
+    char name[] = "/tmp/sentiment_join_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0) {
+        return std::string();
+    }
+    close(fd);
+    std::ofstream out(name, std::ios::binary);
+    for (size_t i = 0; i < lines.size(); i++) {
+        out << lines[i].line << '\n';
+    }
+    return name;
+}
+
+// Reads a whole (small) file into a string.
+static std::string readWholeFile(const char* fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+int runJoinBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 5;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 2) ? argv[2] : dataFile("test_dataset_10k.csv");
+    std::string sentimentFile = (argc > 3) ? argv[3] : dataFile("test_dataset_sentiment_10k.csv");
+
+    // The ID field of every test line, and both indexes of the ground truth.
+    std::vector<DSString> testIds;
+    {
+        MappedFile file(testFile.c_str());
+        DSStringView contents = file.view();
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 1) {
+                testIds.push_back(fields[0].toDSString());
+            }
+        }
+    }
+    MappedFile truthFile(sentimentFile.c_str());
+    StringHashMap<int> byText;
+    {
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(truthFile.view(), offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 2) {
+                byText[fields[1]] = (fields[0] == "4") ? 4 : 0;
+            }
+        }
+    }
+    GroundTruthTable table;
+    table.load(truthFile.view());
+
+    // Parity of the two indexes on every test ID.
+    size_t mismatches = 0;
+    for (size_t i = 0; i < testIds.size(); i++) {
+        const int* expected = byText.find(testIds[i]);
+        int sentiment = -1;
+        bool found = table.lookup(TweetId::parse(testIds[i]), sentiment) == TRUTH_FOUND;
+        if (found != (expected != nullptr) || (found && sentiment != *expected)) {
+            mismatches++;
+        }
+    }
+
+    unsigned long long lookups = (unsigned long long)testIds.size() * rounds;
+    BenchTimer timer;
+    size_t sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < testIds.size(); i++) {
+            const int* found = byText.find(testIds[i]);
+            sum += (found != nullptr) ? *found : 1;
+        }
+    }
+    doNotOptimize(sum);
+    reportResult("join.lookup", "string_map", byText.size(), lookups, timer.seconds());
+
+    timer.restart();
+    sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < testIds.size(); i++) {
+            int sentiment = 1;
+            table.lookup(TweetId::parse(testIds[i]), sentiment);
+            sum += sentiment;
+        }
+    }
+    doNotOptimize(sum);
+    reportResult("join.lookup", "int_table", table.size(), lookups, timer.seconds());
+
+    // Both evaluate modes on sorted copies of the files.
+    std::string sortedTests = writeSortedCopy(testFile.c_str(), 0);
+    std::string sortedTruth = writeSortedCopy(sentimentFile.c_str(), 1);
+    if (sortedTests.empty() || sortedTruth.empty()) {
+        fprintf(stderr, "join: cannot create temporary files\n");
+        return 1;
+    }
+    std::string tableAccuracy = sortedTests + ".table";
+    std::string mergeAccuracy = sortedTests + ".merge";
+
+    SentimentClassifier classifier;
+    classifier.train(trainingFile.c_str());
+    float accuracy = 0.0f;
+    timer.restart();
+    for (int r = 0; r < rounds; r++) {
+        accuracy = classifier.evaluate(sortedTests.c_str(), sortedTruth.c_str(), "/dev/null", tableAccuracy.c_str());
+    }
+    reportResult("join.evaluate", "table", testIds.size(), (unsigned long long)rounds, timer.seconds());
+
+    float sortedAccuracy = 0.0f;
+    bool sortedOk = true;
+    timer.restart();
+    for (int r = 0; r < rounds; r++) {
+        sortedOk = classifier.evaluateSorted(sortedTests.c_str(), sortedTruth.c_str(), "/dev/null",
+                                             mergeAccuracy.c_str(), sortedAccuracy) && sortedOk;
+    }
+    reportResult("join.evaluate", "merge", testIds.size(), (unsigned long long)rounds, timer.seconds());
+
+    bool sameReport = sortedOk && accuracy == sortedAccuracy &&
+                      readWholeFile(tableAccuracy.c_str()) == readWholeFile(mergeAccuracy.c_str());
+    remove(sortedTests.c_str());
+    remove(sortedTruth.c_str());
+    remove(tableAccuracy.c_str());
+    remove(mergeAccuracy.c_str());
+
+    bool ok = mismatches == 0 && sameReport;
+    printf("bench=join.check mismatches=%zu accuracy=%.4f same_report=%s status=%s\n", mismatches, accuracy,
+           sameReport ? "yes" : "no", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
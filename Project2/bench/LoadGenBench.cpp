@@ -0,0 +1,247 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "ScoringProtocol.h"
+#include "ScoringServer.h"
+#include "SentimentClassifier.h"
+#include <cerrno>
+#include <cstdlib>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+// Load generator for the scoring daemon (sentiment serve): several connections each keep
+// 'depth' requests in flight (pipelined) until 'requests' have been answered, and the
+// queries per second and the latency percentiles of the requests are printed. Latency is
+// measured per request, from its send to its reply, so it includes queueing behind the
+// requests ahead of it on the same connection.
+//
+// Without a socket path the benchmark trains on the bundled data, starts a ScoringServer
+// in this process on a temporary socket, and checks every reply against predict; it
+// exits with status 1 if any sentiment differs. With a socket path it loads an external
+// daemon and only measures.
+//
+// Output: bench=loadgen connections= depth= batch= requests= tweets= seconds= qps=
+//         tweets_per_s= p50_ns= p90_ns= p99_ns= max_ns= mismatches= status=
+//
+// Usage: sentiment_bench loadgen [requests] [connections] [depth] [batch] [socket]
+//        (defaults: 200000, 4, 8, 1 tweet per request, an in-process server)
+
+// A request in flight: which prepared request it is and when it was sent.
+struct InFlight {
+    size_t request;
+    std::chrono::steady_clock::time_point sent;
+};
+
+// One client connection with its unread replies and its requests in flight, oldest first.
+struct LoadConnection {
+    int fd;
+    std::vector<char> input;
+    size_t inputEnd;
+    std::vector<InFlight> inFlight;    // ring buffer of 'depth' entries
+    size_t head;
+    size_t count;
+};
+
+// Connects to the daemon's socket. Returns -1 on error.
+static int connectTo(const char* path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Sends all of data[0 .. length).
+static bool sendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+int runLoadGenBench(int argc, char* argv[]) {
+    size_t requests = (argc > 0) ? strtoull(argv[0], nullptr, 10) : 200000;
+    size_t connectionCount = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 4;
+    size_t depth = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 8;
+    size_t batch = (argc > 3) ? strtoull(argv[3], nullptr, 10) : 1;
+    bool inProcess = argc <= 4;
+    std::string socketPath = inProcess ? "/tmp/sentiment_loadgen_" + std::to_string(getpid()) + ".sock" : argv[4];
+    if (connectionCount == 0 || depth == 0 || batch == 0) {
+        fprintf(stderr, "loadgen: connections, depth and batch must be positive\n");
+        return 1;
+    }
+
+    // The test tweets, cut into requests of 'batch' tweets each.
+    std::vector<DSString> tweets;
+    {
+        MappedFile file(dataFile("test_dataset_10k.csv").c_str());
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(file.view(), offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 5) {
+                tweets.push_back(fields[4].toDSString());
+            }
+        }
+    }
+    std::vector<DSStringView> views(tweets.begin(), tweets.end());
+    std::vector<char> frames;
+    std::vector<size_t> frameOffsets;   // prepared request i is frames[frameOffsets[i] .. frameOffsets[i + 1])
+    std::vector<size_t> firstTweet;
+    for (size_t start = 0; start < views.size(); start += batch) {
+        frameOffsets.push_back(frames.size());
+        firstTweet.push_back(start);
+        ScoringProtocol::appendRequest(frames, views.data() + start, std::min(batch, views.size() - start));
+    }
+    frameOffsets.push_back(frames.size());
+    size_t prepared = firstTweet.size();
+
+    // The reference model and, by default, the daemon serving it.
+    SentimentClassifier classifier;
+    std::vector<char> expected;
+    ScoringServer server(classifier);
+    std::thread serverThread;
+    if (inProcess) {
+        classifier.train(dataFile("train_dataset_20k.csv").c_str());
+        for (size_t i = 0; i < views.size(); i++) {
+            expected.push_back((char)classifier.predict(views[i]));
+        }
+        if (!server.listen(socketPath.c_str())) {
+            return 1;
+        }
+        serverThread = std::thread([&server] { server.run(); });
+    }
+
+    std::vector<LoadConnection> connections(connectionCount);
+    std::vector<struct pollfd> polls(connectionCount);
+    bool ok = true;
+    for (size_t c = 0; c < connectionCount; c++) {
+        connections[c].fd = connectTo(socketPath.c_str());
+        connections[c].input.resize(1 << 16);
+        connections[c].inputEnd = 0;
+        connections[c].inFlight.resize(depth);
+        connections[c].head = 0;
+        connections[c].count = 0;
+        polls[c].fd = connections[c].fd;
+        polls[c].events = POLLIN;
+        ok = ok && connections[c].fd >= 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "loadgen: cannot connect to %s\n", socketPath.c_str());
+    }
+
+    LatencySamples latencies;
+    latencies.reserve(requests);
+    size_t sent = 0;
+    size_t completed = 0;
+    unsigned long long tweetsScored = 0;
+    size_t mismatches = 0;
+    BenchTimer timer;
+    while (ok && completed < requests) {
+        // Top every connection up to 'depth' requests in flight.
+        for (size_t c = 0; ok && c < connectionCount; c++) {
+            LoadConnection& connection = connections[c];
+            while (ok && connection.count < depth && sent < requests) {
+                size_t request = sent % prepared;
+                InFlight& slot = connection.inFlight[(connection.head + connection.count) % depth];
+                slot.request = request;
+                slot.sent = std::chrono::steady_clock::now();
+                ok = sendAll(connection.fd, frames.data() + frameOffsets[request],
+                             frameOffsets[request + 1] - frameOffsets[request]);
+                connection.count++;
+                sent++;
+            }
+        }
+        if (!ok || poll(polls.data(), polls.size(), 10000) <= 0) {
+            fprintf(stderr, "loadgen: the server stopped answering\n");
+            ok = false;
+            break;
+        }
+        // Read the replies that arrived and match them with the oldest requests in flight.
+        for (size_t c = 0; ok && c < connectionCount; c++) {
+            if (polls[c].revents == 0) {
+                continue;
+            }
+            LoadConnection& connection = connections[c];
+            if (connection.input.size() - connection.inputEnd < 4096) {
+                connection.input.resize(connection.input.size() * 2);
+            }
+            ssize_t received = read(connection.fd, connection.input.data() + connection.inputEnd,
+                                    connection.input.size() - connection.inputEnd);
+            if (received <= 0) {
+                fprintf(stderr, "loadgen: the server closed a connection\n");
+                ok = false;
+                break;
+            }
+            connection.inputEnd += (size_t)received;
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            size_t offset = 0;
+            size_t frameBytes = 0;
+            while (ScoringProtocol::nextFrame(connection.input.data() + offset, connection.inputEnd - offset,
+                                              frameBytes) == ScoringProtocol::FRAME_COMPLETE) {
+                size_t count = 0;
+                const char* sentiments = nullptr;
+                const InFlight& oldest = connection.inFlight[connection.head];
+                size_t requested = std::min(batch, views.size() - firstTweet[oldest.request]);
+                if (connection.count == 0 ||
+                    !ScoringProtocol::parseResponse(connection.input.data() + offset + ScoringProtocol::LENGTH_BYTES,
+                                                    frameBytes - ScoringProtocol::LENGTH_BYTES, count, sentiments) ||
+                    count != requested) {
+                    fprintf(stderr, "loadgen: malformed reply\n");
+                    ok = false;
+                    break;
+                }
+                if (inProcess &&
+                    memcmp(sentiments, expected.data() + firstTweet[oldest.request], count) != 0) {
+                    mismatches++;
+                }
+                latencies.add(std::chrono::duration<double, std::nano>(now - oldest.sent).count());
+                tweetsScored += count;
+                connection.head = (connection.head + 1) % depth;
+                connection.count--;
+                completed++;
+                offset += frameBytes;
+            }
+            memmove(connection.input.data(), connection.input.data() + offset, connection.inputEnd - offset);
+            connection.inputEnd -= offset;
+        }
+    }
+    double seconds = timer.seconds();
+
+    for (size_t c = 0; c < connectionCount; c++) {
+        if (connections[c].fd >= 0) {
+            close(connections[c].fd);
+        }
+    }
+    if (inProcess) {
+        server.stop();
+        serverThread.join();
+    }
+
+    ok = ok && mismatches == 0;
+    printf("bench=loadgen connections=%zu depth=%zu batch=%zu requests=%zu tweets=%llu seconds=%.6f qps=%.1f "
+           "tweets_per_s=%.1f p50_ns=%.0f p90_ns=%.0f p99_ns=%.0f max_ns=%.0f mismatches=%zu status=%s\n",
+           connectionCount, depth, batch, completed, tweetsScored, seconds, seconds > 0.0 ? completed / seconds : 0.0,
+           seconds > 0.0 ? tweetsScored / seconds : 0.0, latencies.percentile(50), latencies.percentile(90),
+           latencies.percentile(99), latencies.percentile(100), mismatches,
+           ok ? (inProcess ? "ok" : "unchecked") : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "Benchmark.h"
+#include "SentimentClassifier.h"
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+// Saving and loading a model (SentimentClassifier::save/load). Times save and load of a
+// model trained on the training file, then checks that the file a training run writes
+// does not depend on what the classifier held before: a classifier that loaded a model
+// and is then trained must save exactly the file a fresh classifier trained on the same
+// data saves, and trainParallel must save exactly the file train saves at any thread
+// count. Exits with status 1 if any saved file differs.
+//
+// Usage: sentiment_bench model [rounds] [training.csv]
+//        (defaults: 20 rounds, the bundled 20k training set)
+
+// The bytes of a saved model file (empty if it cannot be read).
+static std::string fileBytes(const char* name) {
+    std::ifstream in(name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// The bytes of the model 'classifier' saves (empty if it cannot be saved).
+static std::string savedModel(const SentimentClassifier& classifier) {
+    char name[] = "/tmp/sentiment_model_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0) {
+        return std::string();
+    }
+    close(fd);
+    std::string bytes;
+    if (classifier.save(name)) {
+        bytes = fileBytes(name);
+    }
+    unlink(name);
+    return bytes;
+}
+
+int runModelBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 20;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    if (rounds < 1) {
+        rounds = 1;
+    }
+
+    SentimentClassifier trained;
+    if (!trained.train(trainingFile.c_str())) {
+        printf("bench=model.check status=FAILED (cannot read %s)\n", trainingFile.c_str());
+        return 1;
+    }
+    std::string expected = savedModel(trained);
+
+    char name[] = "/tmp/sentiment_model_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0) {
+        printf("bench=model.check status=FAILED (no temporary file)\n");
+        return 1;
+    }
+    close(fd);
+
+    BenchTimer timer;
+    bool saved = true;
+    for (int r = 0; r < rounds; r++) {
+        saved = trained.save(name) && saved;
+    }
+    double saveSeconds = timer.seconds();
+    printf("bench=model.save rounds=%d bytes=%zu seconds=%.6f ms_per_save=%.3f\n", rounds, expected.size(),
+           saveSeconds, saveSeconds * 1e3 / rounds);
+
+    bool loadedOk = true;
+    timer.restart();
+    for (int r = 0; r < rounds; r++) {
+        SentimentClassifier loaded;
+        loadedOk = loaded.load(name) && loadedOk;
+    }
+    double loadSeconds = timer.seconds();
+    printf("bench=model.load rounds=%d seconds=%.6f ms_per_load=%.3f\n", rounds, loadSeconds,
+           loadSeconds * 1e3 / rounds);
+
+    // Load, then train: the loaded model must not leak into the new one.
+    SentimentClassifier retrained;
+    bool sameAfterLoad = retrained.load(name) && savedModel(retrained) == expected;
+    retrained.train(trainingFile.c_str());
+    sameAfterLoad = sameAfterLoad && savedModel(retrained) == expected;
+    unlink(name);
+
+    // Sharded training merges per-thread counts; the file must not show it.
+    bool sameParallel = true;
+    const unsigned threadCounts[] = { 1, 3, 8 };
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+        SentimentClassifier parallel;
+        parallel.trainParallel(trainingFile.c_str(), threadCounts[i]);
+        sameParallel = savedModel(parallel) == expected && sameParallel;
+    }
+
+    bool ok = saved && loadedOk && !expected.empty() && sameAfterLoad && sameParallel;
+    printf("bench=model.check load_then_train=%s parallel=%s status=%s\n", sameAfterLoad ? "same" : "DIFFERENT",
+           sameParallel ? "same" : "DIFFERENT", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
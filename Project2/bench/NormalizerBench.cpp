@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "TextNormalizer.h"
+#include "TextProcessor.h"
+#include "Tokenizer.h"
+#include <cstdlib>
+
+// Tokens per second of the chained TextProcessor pipeline (owning DSStrings and the
+// DSStringView overloads) against the fused TextNormalizer on real tweets, plus a parity
+// check: every tweet must produce exactly the same tokens through all three paths.
+// Exits with status 1 on any difference.
+//
+// Usage: sentiment_bench normalizer [rounds] [training.csv]   (defaults: 5, the bundled 20k set)
+
+// The pipeline the classifier used before TextNormalizer, stage by stage.
+static std::vector<DSString> chainedPipeline(const DSString& tweetText) {
+    DSString cleaned = TextProcessor::removePunctuation(TextProcessor::toLower(tweetText));
+    std::vector<DSString> tokens = Tokenizer::tokenize(cleaned, ' ');
+    tokens = TextProcessor::removeStopWords(tokens);
+    std::vector<DSString> stemmedTokens;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        stemmedTokens.push_back(TextProcessor::stem(tokens[i]));
+    }
+    return stemmedTokens;
+}
+
+// The same chain through the DSStringView overloads: the stages write into an arena
+// that is reset per tweet and hand views along, so no per-token strings are allocated.
+struct ViewPipeline {
+    Arena scratch;
+    std::vector<DSStringView> tokens;
+    std::vector<DSStringView> filtered;
+
+    const std::vector<DSStringView>& run(const DSStringView& tweetText) {
+        scratch.reset();
+        DSStringView lowered = TextProcessor::toLower(tweetText, scratch);
+        DSStringView cleaned = TextProcessor::removePunctuation(lowered, scratch);
+        Tokenizer::tokenize(cleaned, ' ', tokens);
+        TextProcessor::removeStopWords(tokens, filtered);
+        for (size_t i = 0; i < filtered.size(); i++) {
+            filtered[i] = TextProcessor::stem(filtered[i]);
+        }
+        return filtered;
+    }
+};
+
+// Collects the tweet text (sixth field) of every training line.
+static std::vector<DSString> loadTrainingTweets(const char* trainingFile) {
+    std::vector<DSString> tweets;
+    MappedFile file(trainingFile);
+    DSStringView contents = file.view();
+    CsvRecord fields;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() >= 6) {
+            tweets.push_back(fields[5].toDSString());
+        }
+    }
+    return tweets;
+}
+
+int runNormalizerBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 5;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    std::vector<DSString> tweets = loadTrainingTweets(trainingFile.c_str());
+    TextNormalizer normalizer;
+    ViewPipeline views;
+
+    // Parity: all paths must agree token for token.
+    size_t mismatches = 0;
+    unsigned long long tokensPerRound = 0;
+    for (size_t i = 0; i < tweets.size(); i++) {
+        std::vector<DSString> expected = chainedPipeline(tweets[i]);
+        const std::vector<DSStringView>& actual = normalizer.normalize(tweets[i]);
+        const std::vector<DSStringView>& viewed = views.run(tweets[i]);
+        tokensPerRound += expected.size();
+        bool same = expected.size() == actual.size() && expected.size() == viewed.size();
+        for (size_t j = 0; same && j < expected.size(); j++) {
+            same = actual[j] == DSStringView(expected[j]) && viewed[j] == DSStringView(expected[j]);
+        }
+        if (!same) {
+            mismatches++;
+        }
+    }
+
+    BenchTimer timer;
+    size_t produced = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < tweets.size(); i++) {
+            produced += chainedPipeline(tweets[i]).size();
+        }
+    }
+    doNotOptimize(produced);
+    reportResult("normalizer.tokens", "chained", tweets.size(), tokensPerRound * rounds, timer.seconds());
+
+    timer.restart();
+    produced = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < tweets.size(); i++) {
+            produced += views.run(tweets[i]).size();
+        }
+    }
+    doNotOptimize(produced);
+    reportResult("normalizer.tokens", "views", tweets.size(), tokensPerRound * rounds, timer.seconds());
+
+    timer.restart();
+    produced = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < tweets.size(); i++) {
+            produced += normalizer.normalize(tweets[i]).size();
+        }
+    }
+    doNotOptimize(produced);
+    reportResult("normalizer.tokens", "fused", tweets.size(), tokensPerRound * rounds, timer.seconds());
+
+    printf("bench=normalizer.check mismatches=%zu status=%s\n", mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include <cstdlib>
+#include <thread>
+
+// Concurrent scoring stress check: scores every test tweet serially, then has N threads
+// score the whole set at the same time on the same classifier, and verifies every
+// concurrent prediction equals the serial one. Exits with status 1 on any mismatch.
+//
+// Usage: sentiment_bench predict_concurrent [threads] [rounds] [training.csv] [tests.csv]
+//        (defaults: 8 threads, 3 rounds, the bundled 20k/10k datasets)
+
+// Collects the tweet text (fifth field) of every test line.
+static std::vector<DSString> loadTweets(const char* testFile) {
+    std::vector<DSString> tweets;
+    MappedFile file(testFile);
+    DSStringView contents = file.view();
+    CsvRecord fields;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() >= 5) {
+            tweets.push_back(fields[4].toDSString());
+        }
+    }
+    return tweets;
+}
+
+// Scores all tweets 'rounds' times and counts predictions that differ from 'expected'.
+static void scoreAll(const SentimentClassifier* classifier, const std::vector<DSString>* tweets,
+                     const std::vector<int>* expected, int rounds, size_t* mismatches) {
+    size_t bad = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < tweets->size(); i++) {
+            if (classifier->predict((*tweets)[i]) != (*expected)[i]) {
+                bad++;
+            }
+        }
+    }
+    *mismatches = bad;
+}
+
+int runPredictConcurrentBench(int argc, char* argv[]) {
+    unsigned threads = (argc > 0) ? (unsigned)atoi(argv[0]) : 8;
+    int rounds = (argc > 1) ? atoi(argv[1]) : 3;
+    std::string trainingFile = (argc > 2) ? argv[2] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 3) ? argv[3] : dataFile("test_dataset_10k.csv");
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    SentimentClassifier classifier;
+    classifier.train(trainingFile.c_str());
+    std::vector<DSString> tweets = loadTweets(testFile.c_str());
+
+    // Serial reference predictions.
+    BenchTimer timer;
+    std::vector<int> expected(tweets.size());
+    for (size_t i = 0; i < tweets.size(); i++) {
+        expected[i] = classifier.predict(tweets[i]);
+    }
+    reportResult("predict_concurrent.serial", "threads=1", tweets.size(), tweets.size(), timer.seconds());
+
+    // All threads score the full set against the one shared classifier.
+    timer.restart();
+    std::vector<size_t> mismatches(threads, 0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.push_back(std::thread(scoreAll, &classifier, &tweets, &expected, rounds, &mismatches[t]));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    double seconds = timer.seconds();
+
+    size_t totalMismatches = 0;
+    for (unsigned t = 0; t < threads; t++) {
+        totalMismatches += mismatches[t];
+    }
+    char impl[32];
+    snprintf(impl, sizeof(impl), "threads=%u", threads);
+    reportResult("predict_concurrent.parallel", impl, tweets.size(),
+                 (unsigned long long)tweets.size() * rounds * threads, seconds);
+    printf("bench=predict_concurrent.check mismatches=%zu status=%s\n",
+           totalMismatches, totalMismatches == 0 ? "ok" : "FAILED");
+    return (totalMismatches == 0) ? 0 : 1;
+}
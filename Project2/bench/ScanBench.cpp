@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+#include "ByteScanner.h"
+#include "MappedFile.h"
+#include <cstdlib>
+#include <cstring>
+
+// Throughput (in MB/s) of the ByteScanner kernels at every level the CPU supports, on
+// a whole file held in memory: counting newlines with find(), lowercasing, classifying
+// alnum/space bytes and matching ' '. Every level must produce exactly the scalar
+// results; exits with status 1 on any difference.
+//
+// Usage: sentiment_bench scan [rounds] [file]   (defaults: 20, the bundled 20k training set)
+
+// Prints one kernel measurement in bytes per second.
+static void reportThroughput(const char* bench, ByteScanner::Level level, size_t bytes, int rounds, double seconds) {
+    double mbPerSecond = (seconds > 0.0) ? (double)bytes * rounds / seconds / 1e6 : 0.0;
+    printf("bench=%s impl=%s size=%zu ops=%llu seconds=%.6f mb_per_s=%.1f\n",
+           bench, ByteScanner::levelName(level), bytes, (unsigned long long)bytes * rounds, seconds, mbPerSecond);
+    fflush(stdout);
+}
+
+// Outputs of all kernels for one input; compared across levels.
+struct ScanOutput {
+    size_t lines;
+    std::vector<char> lowered;
+    std::vector<uint64_t> alnum;
+    std::vector<uint64_t> space;
+    std::vector<uint64_t> blank;
+
+    bool operator==(const ScanOutput& other) const {
+        return lines == other.lines && lowered == other.lowered && alnum == other.alnum
+            && space == other.space && blank == other.blank;
+    }
+};
+
+// Number of '\n' bytes, found one find() call at a time.
+static size_t countNewlines(const char* data, size_t length) {
+    size_t count = 0;
+    size_t position = 0;
+    while (true) {
+        position += ByteScanner::find(data + position, length - position, '\n');
+        if (position == length) {
+            return count;
+        }
+        count++;
+        position++;
+    }
+}
+
+int runScanBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 20;
+    std::string inputFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    MappedFile file(inputFile.c_str());
+    // Copy the file to the heap so every run reads warm memory rather than page faults.
+    std::vector<char> input(file.begin(), file.begin() + file.length());
+    const char* data = input.data();
+    size_t length = input.size();
+    size_t words = ByteScanner::maskWords(length);
+
+    ByteScanner::Level original = ByteScanner::level();
+    ScanOutput reference;
+    size_t mismatches = 0;
+    for (int level = ByteScanner::SCALAR; level <= ByteScanner::supportedLevel(); level++) {
+        ByteScanner::Level current = ByteScanner::setLevel((ByteScanner::Level)level);
+        ScanOutput output;
+        output.lowered.resize(length);
+        output.alnum.resize(words);
+        output.space.resize(words);
+        output.blank.resize(words);
+        // Also check short, unaligned inputs, where the scalar tails do all the work.
+        for (size_t offset = 0; offset < 64 && offset < length; offset++) {
+            size_t n = (length - offset < 100) ? length - offset : 100;
+            std::vector<uint64_t> a(ByteScanner::maskWords(n)), b(ByteScanner::maskWords(n)), c(ByteScanner::maskWords(n));
+            ByteScanner::classify(data + offset, n, a.data(), b.data());
+            ByteScanner::match(data + offset, n, ' ', c.data());
+            for (size_t i = 0; i < n; i++) {
+                unsigned char ch = (unsigned char)data[offset + i];
+                bool alnum = (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+                bool space = ch == ' ' || (ch >= '\t' && ch <= '\r');
+                if (((a[i / 64] >> (i % 64)) & 1) != alnum || ((b[i / 64] >> (i % 64)) & 1) != space
+                    || ((c[i / 64] >> (i % 64)) & 1) != (ch == ' ')) {
+                    mismatches++;
+                }
+            }
+        }
+
+        BenchTimer timer;
+        for (int r = 0; r < rounds; r++) {
+            output.lines = countNewlines(data, length);
+        }
+        reportThroughput("scan.find", current, length, rounds, timer.seconds());
+
+        timer.restart();
+        for (int r = 0; r < rounds; r++) {
+            ByteScanner::toLower(data, output.lowered.data(), length);
+        }
+        reportThroughput("scan.lower", current, length, rounds, timer.seconds());
+
+        timer.restart();
+        for (int r = 0; r < rounds; r++) {
+            ByteScanner::classify(data, length, output.alnum.data(), output.space.data());
+        }
+        reportThroughput("scan.classify", current, length, rounds, timer.seconds());
+
+        timer.restart();
+        for (int r = 0; r < rounds; r++) {
+            ByteScanner::match(data, length, ' ', output.blank.data());
+        }
+        reportThroughput("scan.match", current, length, rounds, timer.seconds());
+
+        if (level == ByteScanner::SCALAR) {
+            reference = output;
+        } else if (!(output == reference)) {
+            mismatches++;
+        }
+    }
+    ByteScanner::setLevel(original);
+
+    printf("bench=scan.check levels=%d mismatches=%zu status=%s\n", (int)ByteScanner::supportedLevel() + 1,
+           mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return (mismatches == 0) ? 0 : 1;
+}
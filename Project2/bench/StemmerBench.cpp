@@ -0,0 +1,132 @@
+#include "Arena.h"
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SuffixStemmer.h"
+#include "TextProcessor.h"
+#include "Tokenizer.h"
+#include <cstdlib>
+
+// Words per second of SuffixStemmer against the hand-written "ing"/"ed"/"s" rules it
+// replaced, and with a longer Porter-style rule set, on every token of the training
+// tweets. Checks that the simple rule table strips exactly what the hand-written rules
+// do, on the training tokens and on every word of up to 6 letters over the rules'
+// alphabet. Exits with status 1 on any difference.
+//
+// Usage: sentiment_bench stemmer [rounds] [training.csv]   (defaults: 10, the bundled 20k set)
+
+// The stemmer before the rule table, kept as the reference.
+static size_t handWrittenStemLength(const char* word, size_t len) {
+    if (len > 4 && word[len - 3] == 'i' && word[len - 2] == 'n' && word[len - 1] == 'g') {
+        return len - 3;
+    }
+    if (len > 3 && word[len - 2] == 'e' && word[len - 1] == 'd') {
+        return len - 2;
+    }
+    if (len > 3 && word[len - 1] == 's') {
+        return len - 1;
+    }
+    return len;
+}
+
+// Porter step 1 (plural and past-tense endings) plus common derivational suffixes,
+// limited to rules that only remove bytes.
+static const SuffixRule PORTER_STYLE_RULES[] = {
+    { "sses", 2, 5 }, { "ies", 2, 4 }, { "ss", 0, 2 }, { "s", 1, 3 },
+    { "eed", 1, 4 }, { "ed", 2, 4 }, { "ing", 3, 5 }, { "ingly", 5, 7 }, { "edly", 4, 6 },
+    { "ly", 2, 5 }, { "ness", 4, 6 }, { "ment", 4, 7 }, { "ful", 3, 6 }, { "less", 4, 6 },
+    { "able", 4, 6 }, { "ible", 4, 6 }, { "ity", 3, 6 }, { "ive", 3, 6 }, { "ous", 3, 6 },
+    { "ise", 3, 6 }, { "ize", 3, 6 }, { "ism", 3, 6 }, { "ist", 3, 6 }, { "er", 2, 5 },
+};
+
+int runStemmerBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 10;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+
+    // Every lowercase, punctuation-free token of the training tweets.
+    MappedFile file(trainingFile.c_str());
+    DSStringView contents = file.view();
+    Arena text;
+    CsvRecord fields;
+    std::vector<DSStringView> words;
+    std::vector<DSStringView> lineTokens;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() < 6) {
+            continue;
+        }
+        DSStringView cleaned = TextProcessor::removePunctuation(TextProcessor::toLower(fields[5], text), text);
+        Tokenizer::tokenize(cleaned, ' ', lineTokens);
+        words.insert(words.end(), lineTokens.begin(), lineTokens.end());
+    }
+
+    SuffixStemmer simple(SuffixStemmer::SIMPLE_RULES, SuffixStemmer::SIMPLE_RULE_COUNT);
+    SuffixStemmer porter(PORTER_STYLE_RULES, sizeof(PORTER_STYLE_RULES) / sizeof(PORTER_STYLE_RULES[0]));
+
+    // Parity on the training words, then on all short words over "adegins" plus one other letter.
+    size_t mismatches = 0;
+    for (size_t i = 0; i < words.size(); i++) {
+        if (simple.stemLength(words[i].data(), words[i].length()) != handWrittenStemLength(words[i].data(), words[i].length())) {
+            mismatches++;
+        }
+    }
+    const char alphabet[] = "adeginsx";
+    const size_t letters = sizeof(alphabet) - 1;
+    char word[6];
+    size_t checked = 0;
+    for (size_t length = 0; length <= sizeof(word); length++) {
+        size_t combinations = 1;
+        for (size_t i = 0; i < length; i++) {
+            combinations *= letters;
+        }
+        for (size_t n = 0; n < combinations; n++) {
+            size_t digits = n;
+            for (size_t i = 0; i < length; i++) {
+                word[i] = alphabet[digits % letters];
+                digits /= letters;
+            }
+            if (simple.stemLength(word, length) != handWrittenStemLength(word, length)) {
+                mismatches++;
+            }
+            checked++;
+        }
+    }
+
+    BenchTimer timer;
+    size_t total = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < words.size(); i++) {
+            total += handWrittenStemLength(words[i].data(), words[i].length());
+        }
+    }
+    doNotOptimize(total);
+    reportResult("stemmer.words", "handwritten", SuffixStemmer::SIMPLE_RULE_COUNT, (unsigned long long)words.size() * rounds, timer.seconds());
+
+    timer.restart();
+    total = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < words.size(); i++) {
+            total += simple.stemLength(words[i].data(), words[i].length());
+        }
+    }
+    doNotOptimize(total);
+    reportResult("stemmer.words", "table.simple", SuffixStemmer::SIMPLE_RULE_COUNT, (unsigned long long)words.size() * rounds, timer.seconds());
+
+    timer.restart();
+    total = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < words.size(); i++) {
+            total += porter.stemLength(words[i].data(), words[i].length());
+        }
+    }
+    doNotOptimize(total);
+    reportResult("stemmer.words", "table.porter", sizeof(PORTER_STYLE_RULES) / sizeof(PORTER_STYLE_RULES[0]),
+                 (unsigned long long)words.size() * rounds, timer.seconds());
+
+    printf("bench=stemmer.check words=%zu generated=%zu mismatches=%zu status=%s\n",
+           words.size(), checked, mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include "Arena.h"
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "StopWordSet.h"
+#include "StringInterner.h"
+#include "TextProcessor.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Lookups per second of StopWordSet::contains against a linear scan of the word list,
+// for the built-in stop words and for a large list (the most common distinct words of
+// the training set), on every token of the training tweets. Also checks that both
+// answer the same for every token, and reports the time to build each set. Exits with
+// status 1 on any difference.
+//
+// Usage: sentiment_bench stopwords [rounds] [large list size] [training.csv]
+//        (defaults: 5, 400, the bundled 20k training set)
+
+// The reference membership test: compare against each word in turn.
+static bool linearContains(const std::vector<DSStringView>& list, const DSStringView& token) {
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i] == token) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Times both lookups for one list and returns the number of tokens they disagree on.
+static size_t measureList(const char* name, const std::vector<DSStringView>& list,
+                          const std::vector<DSStringView>& tokens, int rounds) {
+    std::vector<DSString> owned;
+    std::vector<const char*> words;
+    for (size_t i = 0; i < list.size(); i++) {
+        owned.push_back(list[i].toDSString());
+    }
+    for (size_t i = 0; i < owned.size(); i++) {
+        words.push_back(owned[i].c_str());
+    }
+    std::string buildImpl = std::string(name) + ".build";
+    BenchTimer buildTimer;
+    StopWordSet set(words.data(), words.size());
+    reportResult("stopwords.build", buildImpl.c_str(), list.size(), 1, buildTimer.seconds());
+    if (!set.ok()) {
+        fprintf(stderr, "Error: no hash seed places all %zu %s words.\n", set.size(), name);
+        return tokens.size();     // Every token counts as a mismatch
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        if (set.contains(tokens[i]) != linearContains(list, tokens[i])) {
+            mismatches++;
+        }
+    }
+
+    std::string linearImpl = std::string(name) + ".linear";
+    std::string setImpl = std::string(name) + ".set";
+    BenchTimer timer;
+    size_t hits = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < tokens.size(); i++) {
+            hits += linearContains(list, tokens[i]);
+        }
+    }
+    doNotOptimize(hits);
+    reportResult("stopwords.lookups", linearImpl.c_str(), list.size(), (unsigned long long)tokens.size() * rounds, timer.seconds());
+
+    timer.restart();
+    hits = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < tokens.size(); i++) {
+            hits += set.contains(tokens[i]);
+        }
+    }
+    doNotOptimize(hits);
+    reportResult("stopwords.lookups", setImpl.c_str(), list.size(), (unsigned long long)tokens.size() * rounds, timer.seconds());
+    return mismatches;
+}
+
+int runStopWordBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 5;
+    size_t largeSize = (argc > 1) ? (size_t)atoi(argv[1]) : 400;
+    std::string trainingFile = (argc > 2) ? argv[2] : dataFile("train_dataset_20k.csv");
+
+    // Every lowercase, punctuation-free token of the training tweets, in order.
+    MappedFile file(trainingFile.c_str());
+    DSStringView contents = file.view();
+    Arena text;
+    CsvRecord fields;
+    std::vector<DSStringView> tokens;
+    std::vector<DSStringView> lineTokens;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() < 6) {
+            continue;
+        }
+        DSStringView cleaned = TextProcessor::removePunctuation(TextProcessor::toLower(fields[5], text), text);
+        Tokenizer::tokenize(cleaned, ' ', lineTokens);
+        tokens.insert(tokens.end(), lineTokens.begin(), lineTokens.end());
+    }
+
+    // The built-in list, and a large one: the most frequent distinct tokens.
+    std::vector<DSStringView> builtIn;
+    for (size_t i = 0; i < TextProcessor::stopWords().size(); i++) {
+        builtIn.push_back(TextProcessor::stopWords().wordAt(i));
+    }
+    StringInterner distinct;
+    std::vector<size_t> frequency;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        uint32_t id = distinct.intern(tokens[i]);
+        if (id == frequency.size()) {
+            frequency.push_back(0);
+        }
+        frequency[id]++;
+    }
+    std::vector<uint32_t> byFrequency;
+    for (uint32_t id = 0; id < frequency.size(); id++) {
+        byFrequency.push_back(id);
+    }
+    std::stable_sort(byFrequency.begin(), byFrequency.end(),
+                     [&](uint32_t a, uint32_t b) { return frequency[a] > frequency[b]; });
+    std::vector<DSStringView> large;
+    for (size_t i = 0; i < byFrequency.size() && large.size() < largeSize; i++) {
+        if (distinct.keyAt(byFrequency[i]).length() > 0) {
+            large.push_back(distinct.keyAt(byFrequency[i]));
+        }
+    }
+
+    size_t mismatches = measureList("builtin", builtIn, tokens, rounds);
+    mismatches += measureList("large", large, tokens, rounds);
+    printf("bench=stopwords.check tokens=%zu mismatches=%zu status=%s\n", tokens.size(), mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+#include "AllocationCounter.h"
+#include "Arena.h"
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "DSString.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include "TextNormalizer.h"
+#include "TextProcessor.h"
+#include "Tokenizer.h"
+#include <cstdlib>
+
+// Regression suite for the whole pipeline: every stage on the bundled data, one line per
+// stage with throughput, latency percentiles and heap allocations, so two builds can be
+// compared line by line. The stages are DSString operations, Tokenizer::tokenize, each
+// TextProcessor function (DSString and view versions), the fused TextNormalizer, the term
+// table updates of training, predict, and end-to-end train and evaluate.
+//
+// Each stage runs once to warm up, then 'rounds' times untimed per operation for
+// throughput and allocations, then once more timing every operation for the latency
+// percentiles (which therefore include the clock's own overhead of a few tens of ns).
+// An operation is one tweet, or one whole call for train and evaluate.
+//
+// Output: bench=suite.<stage> ops= seconds= ops_per_s= p50_ns= p90_ns= p99_ns= max_ns=
+//         allocations= allocations_per_op=
+//
+// Usage: sentiment_bench suite [rounds] [training.csv] [tests.csv] [sentiment.csv]
+//        (defaults: 5, the bundled 20k/10k datasets)
+
+// Runs op(0 .. items-1) as described above and prints the stage's line.
+template <typename Op>
+static void runStage(const char* stage, size_t items, int rounds, Op op) {
+    size_t sink = 0;
+    for (size_t i = 0; i < items; i++) {
+        sink += op(i);
+    }
+
+    unsigned long long before = allocationCount();
+    BenchTimer timer;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < items; i++) {
+            sink += op(i);
+        }
+    }
+    double seconds = timer.seconds();
+    unsigned long long allocations = allocationCount() - before;
+
+    LatencySamples latencies;
+    latencies.reserve(items);
+    for (size_t i = 0; i < items; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sink += op(i);
+        latencies.add(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    doNotOptimize(sink);
+
+    unsigned long long ops = (unsigned long long)items * rounds;
+    printf("bench=suite.%s ops=%llu seconds=%.6f ops_per_s=%.1f p50_ns=%.0f p90_ns=%.0f p99_ns=%.0f max_ns=%.0f "
+           "allocations=%llu allocations_per_op=%.3f\n",
+           stage, ops, seconds, seconds > 0.0 ? ops / seconds : 0.0, latencies.percentile(50), latencies.percentile(90),
+           latencies.percentile(99), latencies.percentile(100), allocations, ops > 0 ? (double)allocations / ops : 0.0);
+    fflush(stdout);
+}
+
+// Collects column 'column' of every line of a CSV file that has at least column + 1 fields.
+static std::vector<DSString> loadColumn(const char* fileName, size_t column) {
+    std::vector<DSString> values;
+    MappedFile file(fileName);
+    DSStringView contents = file.view();
+    CsvRecord fields;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() > column) {
+            values.push_back(fields[column].toDSString());
+        }
+    }
+    return values;
+}
+
+int runSuiteBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 5;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 2) ? argv[2] : dataFile("test_dataset_10k.csv");
+    std::string sentimentFile = (argc > 3) ? argv[3] : dataFile("test_dataset_sentiment_10k.csv");
+
+    std::vector<DSString> tweets = loadColumn(trainingFile.c_str(), 5);
+    std::vector<DSString> testTweets = loadColumn(testFile.c_str(), 4);
+    size_t n = tweets.size();
+
+    // Inputs of the later stages, computed once with the stage before them.
+    std::vector<std::vector<DSString> > tokens(n);      // lowercased, punctuation removed, split
+    std::vector<std::vector<DSString> > filtered(n);    // ... and stop words removed
+    std::vector<std::vector<DSString> > normalized(n);  // ... and stemmed
+    for (size_t i = 0; i < n; i++) {
+        tokens[i] = Tokenizer::tokenize(TextProcessor::removePunctuation(TextProcessor::toLower(tweets[i])), ' ');
+        filtered[i] = TextProcessor::removeStopWords(tokens[i]);
+        for (size_t j = 0; j < filtered[i].size(); j++) {
+            normalized[i].push_back(TextProcessor::stem(filtered[i][j]));
+        }
+    }
+    std::vector<std::vector<DSStringView> > tokenViews(n);
+    std::vector<std::vector<DSStringView> > filteredViews(n);
+    for (size_t i = 0; i < n; i++) {
+        tokenViews[i].assign(tokens[i].begin(), tokens[i].end());
+        filteredViews[i].assign(filtered[i].begin(), filtered[i].end());
+    }
+
+    Arena arena;
+    std::vector<DSStringView> scratch;
+
+    // DSString operations.
+    runStage("dsstring.copy", n, rounds, [&](size_t i) {
+        DSString copy(tweets[i]);
+        return copy.length();
+    });
+    runStage("dsstring.append", n, rounds, [&](size_t i) {
+        DSString built;
+        const char* text = tweets[i].c_str();
+        for (size_t j = 0; j < tweets[i].length(); j++) {
+            built.append(text[j]);
+        }
+        return built.length();
+    });
+    runStage("dsstring.compare", n, rounds, [&](size_t i) {
+        return (size_t)(tweets[i] < tweets[(i + 1) % n]) + (size_t)(tweets[i] == tweets[(i + 1) % n]);
+    });
+
+    // Splitting.
+    runStage("tokenizer.tokenize", n, rounds, [&](size_t i) {
+        return Tokenizer::tokenize(tweets[i], ' ').size();
+    });
+    runStage("tokenizer.tokenize_view", n, rounds, [&](size_t i) {
+        Tokenizer::tokenize(DSStringView(tweets[i]), ' ', scratch);
+        return scratch.size();
+    });
+
+    // TextProcessor, stage by stage (the DSString functions, then the view overloads).
+    runStage("textprocessor.toLower", n, rounds, [&](size_t i) {
+        return TextProcessor::toLower(tweets[i]).length();
+    });
+    runStage("textprocessor.toLower_view", n, rounds, [&](size_t i) {
+        arena.reset();
+        return TextProcessor::toLower(DSStringView(tweets[i]), arena).length();
+    });
+    runStage("textprocessor.removePunctuation", n, rounds, [&](size_t i) {
+        return TextProcessor::removePunctuation(tweets[i]).length();
+    });
+    runStage("textprocessor.removePunctuation_view", n, rounds, [&](size_t i) {
+        arena.reset();
+        return TextProcessor::removePunctuation(DSStringView(tweets[i]), arena).length();
+    });
+    runStage("textprocessor.removeStopWords", n, rounds, [&](size_t i) {
+        return TextProcessor::removeStopWords(tokens[i]).size();
+    });
+    runStage("textprocessor.removeStopWords_view", n, rounds, [&](size_t i) {
+        TextProcessor::removeStopWords(tokenViews[i], scratch);
+        return scratch.size();
+    });
+    runStage("textprocessor.stem", n, rounds, [&](size_t i) {
+        size_t length = 0;
+        for (size_t j = 0; j < filtered[i].size(); j++) {
+            length += TextProcessor::stem(filtered[i][j]).length();
+        }
+        return length;
+    });
+    runStage("textprocessor.stem_view", n, rounds, [&](size_t i) {
+        size_t length = 0;
+        for (size_t j = 0; j < filteredViews[i].size(); j++) {
+            length += TextProcessor::stem(filteredViews[i][j]).length();
+        }
+        return length;
+    });
+
+    // The fused normalizer that training and predict use.
+    TextNormalizer normalizer;
+    runStage("normalizer.normalize", n, rounds, [&](size_t i) {
+        return normalizer.normalize(tweets[i]).size();
+    });
+
+    // The term table updates of processTrainingTweet: intern every token of the tweet and
+    // bump its class count and document frequency. The table is warm after the first pass.
+    WordCounts counts;
+    std::vector<int> lastDocument;
+    runStage("training.update", n, rounds, [&](size_t i) {
+        int document = ++counts.positiveTweetCount;
+        for (size_t j = 0; j < normalized[i].size(); j++) {
+            TermId id = counts.internTerm(normalized[i][j]);
+            if (lastDocument.size() <= id) {
+                lastDocument.resize(counts.stats.size(), -1);
+            }
+            counts.stats[id].positive++;
+            if (lastDocument[id] != document) {
+                lastDocument[id] = document;
+                counts.stats[id].documents++;
+            }
+        }
+        return normalized[i].size();
+    });
+
+    // Scoring.
+    SentimentClassifier classifier;
+    classifier.train(trainingFile.c_str());
+    runStage("predict", testTweets.size(), rounds, [&](size_t i) {
+        return (size_t)classifier.predict(testTweets[i]);
+    });
+
+    // End to end on the files, one call per operation ('rounds' calls per pass).
+    runStage("train", rounds, 1, [&](size_t) {
+        SentimentClassifier model;
+        model.train(trainingFile.c_str());
+        return (size_t)model.trainingProgress().records;
+    });
+    runStage("evaluate", rounds, 1, [&](size_t) {
+        return (size_t)(1000 * classifier.evaluate(testFile.c_str(), sentimentFile.c_str(), "/dev/null", "/dev/null"));
+    });
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include <cstdlib>
+
+// Training and encoding throughput at several token cache capacities, with the hit rate
+// of each, plus a parity check: at every capacity the model must have the same
+// vocabulary and every test tweet must encode to the same term IDs as with the cache
+// turned off. Exits with status 1 on any difference.
+//
+// Usage: sentiment_bench tokencache [rounds] [training.csv] [tests.csv]
+//        (defaults: 5, the bundled 20k/10k datasets)
+
+// Collects the tweet text (fifth field) of every test line.
+static std::vector<DSString> loadTestTweets(const char* testFile) {
+    std::vector<DSString> tweets;
+    MappedFile file(testFile);
+    DSStringView contents = file.view();
+    CsvRecord fields;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() >= 5) {
+            tweets.push_back(fields[4].toDSString());
+        }
+    }
+    return tweets;
+}
+
+int runTokenCacheBench(int argc, char* argv[]) {
+    int rounds = (argc > 0) ? atoi(argv[0]) : 5;
+    std::string trainingFile = (argc > 1) ? argv[1] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 2) ? argv[2] : dataFile("test_dataset_10k.csv");
+    std::vector<DSString> tweets = loadTestTweets(testFile.c_str());
+
+    // The reference: no cache.
+    SentimentClassifier reference;
+    reference.setTokenCacheCapacity(0);
+    reference.train(trainingFile.c_str());
+    std::vector<std::vector<TermId> > expected(tweets.size());
+    for (size_t i = 0; i < tweets.size(); i++) {
+        reference.encode(tweets[i], expected[i]);
+    }
+    size_t expectedTerms = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        expectedTerms += expected[i].size();
+    }
+
+    const size_t capacities[] = { 0, 1024, 4096, TokenCache::DEFAULT_CAPACITY, 65536 };
+    size_t mismatches = 0;
+    std::vector<TermId> termIds;
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++) {
+        char impl[32];
+        snprintf(impl, sizeof(impl), "capacity_%zu", capacities[c]);
+
+        // Training: a fresh model per round, so every round starts with a cold cache.
+        TokenCacheStats trainStats;
+        BenchTimer timer;
+        unsigned long long records = 0;
+        for (int r = 0; r < rounds; r++) {
+            SentimentClassifier classifier;
+            classifier.setTokenCacheCapacity(capacities[c]);
+            classifier.train(trainingFile.c_str());
+            records += classifier.trainingProgress().records;
+            trainStats.add(classifier.tokenCacheStats());
+        }
+        double seconds = timer.seconds();
+        reportResult("tokencache.train", impl, capacities[c], records, seconds);
+        printf("bench=tokencache.train.stats impl=%s lookups=%llu hits=%llu uncached=%llu hit_rate=%.4f\n",
+               impl, trainStats.lookups(), trainStats.hits, trainStats.uncached, trainStats.hitRate());
+
+        // Encoding the test tweets with one model; the first round warms the cache.
+        SentimentClassifier classifier;
+        classifier.setTokenCacheCapacity(capacities[c]);
+        classifier.train(trainingFile.c_str());
+        for (size_t i = 0; i < tweets.size(); i++) {
+            classifier.encode(tweets[i], termIds);
+            if (termIds != expected[i]) {
+                mismatches++;
+            }
+        }
+        classifier.resetTokenCacheStats();
+        timer.restart();
+        size_t produced = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < tweets.size(); i++) {
+                classifier.encode(tweets[i], termIds);
+                produced += termIds.size();
+            }
+        }
+        doNotOptimize(produced);
+        seconds = timer.seconds();
+        TokenCacheStats encodeStats = classifier.tokenCacheStats();
+        reportResult("tokencache.encode", impl, capacities[c], (unsigned long long)tweets.size() * rounds, seconds);
+        printf("bench=tokencache.encode.stats impl=%s lookups=%llu hits=%llu uncached=%llu hit_rate=%.4f\n",
+               impl, encodeStats.lookups(), encodeStats.hits, encodeStats.uncached, encodeStats.hitRate());
+        if (produced != expectedTerms * rounds) {
+            mismatches++;
+        }
+    }
+
+    printf("bench=tokencache.check mismatches=%zu status=%s\n", mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return (mismatches == 0) ? 0 : 1;
+}
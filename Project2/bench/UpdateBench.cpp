@@ -0,0 +1,190 @@
+#include "Benchmark.h"
+#include "CsvRecord.h"
+#include "FileIO.h"
+#include "MappedFile.h"
+#include "SentimentClassifier.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+// Incremental updates (SentimentClassifier::update). The training file is split in half;
+// models built from the first half and then updated with the second half in batches of
+// 'batch' tweets must save exactly the same file as a model trained on the whole file.
+// This is checked for a model started by update() itself, one started by train(), and
+// one started by load(). The loaded model is updated while reader threads keep scoring
+// the test set, to show scoring is never paused; their throughput during the updates
+// is printed with the update rate and the latency of each update. Exits with status 1
+// if any saved model differs.
+//
+// Usage: sentiment_bench update [batch] [readers] [training.csv] [tests.csv]
+//        (defaults: 1000 tweets, 2 threads, the bundled 20k/10k datasets)
+
+// The bytes of a saved model (empty if it cannot be saved).
+static std::string savedModel(const SentimentClassifier& classifier) {
+    char name[] = "/tmp/sentiment_update_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0) {
+        return std::string();
+    }
+    close(fd);
+    std::string bytes;
+    if (classifier.save(name)) {
+        std::ifstream in(name, std::ios::binary);
+        bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    }
+    unlink(name);
+    return bytes;
+}
+
+// Updates 'classifier' with lines [begin, end) in batches; returns the latency of each.
+static LatencySamples updateInBatches(SentimentClassifier& classifier, const std::vector<DSStringView>& lines,
+                                      size_t begin, size_t end, size_t batch) {
+    LatencySamples latencies;
+    std::vector<DSStringView> next;
+    for (size_t i = begin; i < end; i += batch) {
+        next.assign(lines.begin() + i, lines.begin() + ((end - i > batch) ? i + batch : end));
+        BenchTimer timer;
+        classifier.update(next);
+        latencies.add(timer.seconds() * 1e9);
+    }
+    return latencies;
+}
+
+// Scores the tweets over and over until 'stop' is set; counts the tweets scored.
+static void scoreUntilStopped(const SentimentClassifier* classifier, const std::vector<DSStringView>* tweets,
+                              const std::atomic<bool>* stop, unsigned long long* scored) {
+    unsigned long long count = 0;
+    size_t positives = 0;
+    while (!stop->load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < tweets->size(); i++) {
+            positives += (size_t)classifier->predict((*tweets)[i]);
+        }
+        count += tweets->size();
+    }
+    doNotOptimize(positives);
+    *scored = count;
+}
+
+int runUpdateBench(int argc, char* argv[]) {
+    size_t batch = (argc > 0) ? (size_t)atol(argv[0]) : 1000;
+    unsigned readers = (argc > 1) ? (unsigned)atoi(argv[1]) : 2;
+    std::string trainingFile = (argc > 2) ? argv[2] : dataFile("train_dataset_20k.csv");
+    std::string testFile = (argc > 3) ? argv[3] : dataFile("test_dataset_10k.csv");
+    if (batch == 0) {
+        batch = 1;
+    }
+
+    MappedFile training(trainingFile.c_str());
+    std::vector<DSStringView> lines;
+    {
+        DSStringView contents = training.view();
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            lines.push_back(line);
+        }
+    }
+    size_t half = lines.size() / 2;
+
+    MappedFile test(testFile.c_str());
+    std::vector<DSStringView> tweets;
+    {
+        DSStringView contents = test.view();
+        CsvRecord fields;
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            fields.parse(line);
+            if (fields.size() >= 5) {
+                tweets.push_back(fields[4]);
+            }
+        }
+    }
+
+    // The reference: one training run over the whole file.
+    BenchTimer timer;
+    SentimentClassifier full;
+    full.train(trainingFile.c_str());
+    double trainSeconds = timer.seconds();
+    std::string expected = savedModel(full);
+    printf("bench=update.train tweets=%zu seconds=%.6f tweets_per_s=%.1f\n", lines.size(), trainSeconds,
+           trainSeconds > 0.0 ? lines.size() / trainSeconds : 0.0);
+
+    // Started by update(): the first half in one batch, the rest in batches.
+    SentimentClassifier updated;
+    std::vector<DSStringView> firstHalf(lines.begin(), lines.begin() + half);
+    updated.update(firstHalf);
+    std::string firstHalfModel = savedModel(updated);
+    updateInBatches(updated, lines, half, lines.size(), batch);
+    bool sameUpdated = savedModel(updated) == expected;
+
+    // Started by train() on a file holding the first half.
+    bool sameTrained = false;
+    {
+        char name[] = "/tmp/sentiment_update_XXXXXX";
+        int fd = mkstemp(name);
+        if (fd >= 0) {
+            close(fd);
+            std::ofstream out(name, std::ios::binary);
+            for (size_t i = 0; i < half; i++) {
+                out.write(lines[i].data(), (std::streamsize)lines[i].length());
+                out.put('\n');
+            }
+            out.close();
+            SentimentClassifier trained;
+            trained.train(name);
+            unlink(name);
+            updateInBatches(trained, lines, half, lines.size(), batch);
+            sameTrained = savedModel(trained) == expected;
+        }
+    }
+
+    // Started by load() of the first half's model, updated while readers keep scoring.
+    bool sameLoaded = false;
+    {
+        char name[] = "/tmp/sentiment_update_XXXXXX";
+        int fd = mkstemp(name);
+        if (fd >= 0) {
+            close(fd);
+            std::ofstream out(name, std::ios::binary);
+            out.write(firstHalfModel.data(), (std::streamsize)firstHalfModel.size());
+            out.close();
+            SentimentClassifier loaded;
+            bool ok = loaded.load(name);
+            unlink(name);
+
+            std::atomic<bool> stop(false);
+            std::vector<unsigned long long> scored(readers, 0);
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < readers; t++) {
+                workers.push_back(std::thread(scoreUntilStopped, &loaded, &tweets, &stop, &scored[t]));
+            }
+            timer.restart();
+            LatencySamples latencies = updateInBatches(loaded, lines, half, lines.size(), batch);
+            double seconds = timer.seconds();
+            stop.store(true);
+            for (size_t t = 0; t < workers.size(); t++) {
+                workers[t].join();
+            }
+            unsigned long long totalScored = 0;
+            for (size_t t = 0; t < scored.size(); t++) {
+                totalScored += scored[t];
+            }
+
+            size_t updates = lines.size() - half;
+            printf("bench=update.batches batch=%zu updates=%zu seconds=%.6f tweets_per_s=%.1f p50_ms=%.3f p99_ms=%.3f\n",
+                   batch, updates, seconds, seconds > 0.0 ? updates / seconds : 0.0,
+                   latencies.percentile(50) / 1e6, latencies.percentile(99) / 1e6);
+            printf("bench=update.readers threads=%u scored=%llu tweets_per_s=%.1f\n", readers, totalScored,
+                   seconds > 0.0 ? totalScored / seconds : 0.0);
+            sameLoaded = ok && savedModel(loaded) == expected;
+        }
+    }
+
+    bool ok = !expected.empty() && sameUpdated && sameTrained && sameLoaded;
+    printf("bench=update.check from_update=%s from_train=%s from_load=%s status=%s\n", sameUpdated ? "same" : "DIFFERENT",
+           sameTrained ? "same" : "DIFFERENT", sameLoaded ? "same" : "DIFFERENT", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
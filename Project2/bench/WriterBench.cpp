@@ -0,0 +1,80 @@
+#include "AsyncFileWriter.h"
+#include "Benchmark.h"
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+
+// Cost of writing results lines ("4, 1467810369") the way evaluate used to, through a
+// std::ofstream and operator<<, against AsyncFileWriter, in nanoseconds per line, plus
+// a parity check: both files must be byte-for-byte identical. The time of the writer
+// includes close(), i.e. waiting for the last buffers to reach the file. Exits with
+// status 1 on any difference.
+//
+// Usage: sentiment_bench writer [lines] [directory]   (defaults: 10000000, /tmp)
+
+// The tweet ID and prediction of line i: ten-digit IDs like the bundled data's.
+static unsigned long long lineId(size_t i) {
+    return 1467810369ull + i * 7919ull % 1000000000ull;
+}
+static int linePrediction(size_t i) {
+    return ((i * 2654435761u) >> 7) & 1 ? 4 : 0;
+}
+
+// Compares two files byte for byte.
+static bool sameContents(const char* first, const char* second) {
+    std::ifstream a(first, std::ios::binary);
+    std::ifstream b(second, std::ios::binary);
+    char bufferA[65536];
+    char bufferB[65536];
+    for (;;) {
+        a.read(bufferA, sizeof(bufferA));
+        b.read(bufferB, sizeof(bufferB));
+        if (a.gcount() != b.gcount() || memcmp(bufferA, bufferB, (size_t)a.gcount()) != 0) {
+            return false;
+        }
+        if (a.gcount() == 0) {
+            return true;
+        }
+    }
+}
+
+int runWriterBench(int argc, char* argv[]) {
+    size_t lines = (argc > 0) ? strtoull(argv[0], nullptr, 10) : 10000000;
+    std::string directory = (argc > 1) ? argv[1] : "/tmp";
+    std::string streamFile = directory + "/sentiment_writer_stream.csv";
+    std::string asyncFile = directory + "/sentiment_writer_async.csv";
+
+    BenchTimer timer;
+    {
+        std::ofstream out(streamFile.c_str());
+        for (size_t i = 0; i < lines; i++) {
+            out << linePrediction(i) << ", " << lineId(i) << '\n';
+        }
+    }
+    double seconds = timer.seconds();
+    printf("bench=writer.results impl=ofstream lines=%zu seconds=%.6f ns_per_line=%.1f\n", lines, seconds,
+           lines > 0 ? seconds * 1e9 / lines : 0.0);
+
+    timer.restart();
+    bool written;
+    {
+        AsyncFileWriter out;
+        written = out.open(asyncFile.c_str());
+        for (size_t i = 0; written && i < lines; i++) {
+            out.writeInt(linePrediction(i));
+            out.write(", ", 2);
+            out.writeInt((long long)lineId(i));
+            out.put('\n');
+        }
+        written = out.close() && written;
+    }
+    seconds = timer.seconds();
+    printf("bench=writer.results impl=async lines=%zu seconds=%.6f ns_per_line=%.1f\n", lines, seconds,
+           lines > 0 ? seconds * 1e9 / lines : 0.0);
+
+    bool same = written && sameContents(streamFile.c_str(), asyncFile.c_str());
+    unlink(streamFile.c_str());
+    unlink(asyncFile.c_str());
+    printf("bench=writer.check same=%s status=%s\n", same ? "yes" : "no", same ? "ok" : "FAILED");
+    return same ? 0 : 1;
+}
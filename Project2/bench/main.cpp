@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstring>
+#include "Benchmark.h"
+
+// Entry point of sentiment_bench.
+// Usage: sentiment_bench            runs every benchmark with its defaults
+//        sentiment_bench <name> ... runs one benchmark, passing it the remaining arguments
+
+struct BenchEntry {
+    const char* name;
+    int (*run)(int argc, char* argv[]);
+};
+
+static const BenchEntry benches[] = {
+    { "hashmap", runHashMapBench },
+    { "predict_concurrent", runPredictConcurrentBench },
+    { "normalizer", runNormalizerBench },
+    { "dsstring", runDSStringBench },
+    { "allocations", runAllocationBench },
+    { "csv", runCsvBench },
+    { "scan", runScanBench },
+    { "stopwords", runStopWordBench },
+    { "stemmer", runStemmerBench },
+    { "tokencache", runTokenCacheBench },
+    { "join", runJoinBench },
+    { "writer", runWriterBench },
+    { "loadgen", runLoadGenBench },
+    { "classify", runClassifyBench },
+    { "update", runUpdateBench },
+    { "model", runModelBench },
+    { "suite", runSuiteBench },
+};
+static const size_t benchCount = sizeof(benches) / sizeof(benches[0]);
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        for (size_t i = 0; i < benchCount; i++) {
+            int status = benches[i].run(0, argv + argc);
+            if (status != 0) {
+                return status;
+            }
+        }
+        return 0;
+    }
+    for (size_t i = 0; i < benchCount; i++) {
+        if (strcmp(argv[1], benches[i].name) == 0) {
+            return benches[i].run(argc - 2, argv + 2);
+        }
+    }
+    fprintf(stderr, "Unknown benchmark '%s'. Available:", argv[1]);
+    for (size_t i = 0; i < benchCount; i++) {
+        fprintf(stderr, " %s", benches[i].name);
+    }
+    fprintf(stderr, "\n");
+    return 1;
+}
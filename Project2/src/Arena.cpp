@@ -0,0 +1,78 @@
+#include "Arena.h"      // Include the header file for the Arena class
+#include <cstdint>      // Include cstdint for uintptr_t (pointer alignment)
+#include <cstring>      // Include cstring for memcpy()
+
+// Constructor: no block is allocated until the first allocate() call
+Arena::Arena(size_t blockSize) : blockSize(blockSize > 0 ? blockSize : 1), current(0), used(0), heapAllocations(0) {
+}
+
+// Destructor: free every block
+Arena::~Arena() {
+    for (size_t i = 0; i < blocks.size(); i++) {
+        delete[] blocks[i].data;
+    }
+}
+
+// Carve 'bytes' bytes out of the current block, moving on to the next kept block
+// (or a new one) when it does not fit
+char* Arena::allocate(size_t bytes, size_t alignment) {
+    while (current < blocks.size()) {
+        Block& block = blocks[current];
+        size_t start = (size_t)(((uintptr_t)block.data + used + alignment - 1) & ~(uintptr_t)(alignment - 1))
+                     - (size_t)(uintptr_t)block.data;   // First aligned offset at or after 'used'
+        if (start <= block.size && bytes <= block.size - start) {
+            used = start + bytes;
+            return block.data + start;
+        }
+        if (current + 1 == blocks.size()) {
+            break;                // Every kept block is in use: get a new one below
+        }
+        current++;                // Try the next block kept from before the last reset
+        used = 0;
+    }
+
+    // Allocate a new block, large enough for this request even if it exceeds blockSize.
+    Block block;
+    block.size = (bytes + alignment - 1 > blockSize) ? bytes + alignment - 1 : blockSize;
+    block.data = new char[block.size];
+    heapAllocations++;
+    blocks.push_back(block);
+    current = blocks.size() - 1;
+    size_t start = (size_t)(((uintptr_t)block.data + alignment - 1) & ~(uintptr_t)(alignment - 1))
+                 - (size_t)(uintptr_t)block.data;
+    used = start + bytes;
+    return block.data + start;
+}
+
+// Copy a run of characters into the arena
+DSStringView Arena::copy(const DSStringView& text) {
+    char* bytes = allocate(text.length());
+    memcpy(bytes, text.data(), text.length());
+    return DSStringView(bytes, text.length());
+}
+
+// Rewind to the start of the first block; nothing is freed
+void Arena::reset() {
+    current = 0;
+    used = 0;
+}
+
+size_t Arena::bytesUsed() const {
+    size_t total = used;
+    for (size_t i = 0; i < current && i < blocks.size(); i++) {
+        total += blocks[i].size;  // Earlier blocks count as full (their tails were skipped)
+    }
+    return total;
+}
+
+size_t Arena::capacity() const {
+    size_t total = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        total += blocks[i].size;
+    }
+    return total;
+}
+
+unsigned long long Arena::blockAllocations() const {
+    return heapAllocations;
+}
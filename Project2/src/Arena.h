@@ -0,0 +1,54 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+#include "DSStringView.h"
+
+// Bump allocator for short-lived scratch memory (e.g. the temporaries of one tweet).
+// allocate() carves memory out of large blocks by advancing a pointer, and reset()
+// releases everything at once in O(1) by rewinding to the first block. Blocks are
+// kept across resets, so once an arena has grown to its working size, allocating
+// from it never touches the heap again. Memory is only returned by the destructor.
+class Arena {
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+    std::vector<Block> blocks;  // every block obtained so far, in carving order
+    size_t blockSize;           // size of a new block (larger if one request needs more)
+    size_t current;             // index of the block being carved
+    size_t used;                // bytes already carved from blocks[current]
+    unsigned long long heapAllocations; // blocks obtained from the heap over the arena's lifetime
+
+    // Not copyable: the blocks are owned by exactly one arena.
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+public:
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+
+    // Returns 'bytes' bytes aligned to 'alignment' (a power of two), valid until reset().
+    char* allocate(size_t bytes, size_t alignment = 1);
+
+    // Copies the viewed characters into the arena and returns a view of the copy.
+    DSStringView copy(const DSStringView& text);
+
+    // Releases every allocation at once; the blocks are kept for reuse.
+    void reset();
+
+    // Bytes handed out since the last reset (including alignment padding of the current block).
+    size_t bytesUsed() const;
+
+    // Total size of the blocks the arena holds.
+    size_t capacity() const;
+
+    // Number of times the arena has had to allocate a block from the heap.
+    // Stays constant in steady state, which is what callers can check.
+    unsigned long long blockAllocations() const;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,174 @@
+#include "AsyncFileWriter.h"  // Include the header file for the AsyncFileWriter class
+#include <cerrno>                 // Include cerrno to retry writes interrupted by a signal
+#include <fcntl.h>                // Include fcntl.h for open()
+#include <unistd.h>               // Include unistd.h for write(), pwrite() and close()
+
+// Write all of data[0 .. length) to the descriptor, at 'offset' or (if negative) at the
+// current file position, retrying short and interrupted writes.
+static bool writeFully(int fd, const char* data, size_t length, long long offset) {
+    while (length > 0) {
+        ssize_t written = (offset < 0) ? ::write(fd, data, length) : ::pwrite(fd, data, length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;         // Interrupted before anything was written: try again
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+        if (offset >= 0) {
+            offset += written;
+        }
+    }
+    return true;
+}
+
+// Constructor: nothing open, no buffers yet (they are allocated by the first open()).
+AsyncFileWriter::AsyncFileWriter(size_t bufferSize)
+    : fd(-1), ownsFd(false), bufferSize(bufferSize > 0 ? bufferSize : 1), current(nullptr), currentIndex(0), used(0),
+      pendingHead(0), pendingCount(0), freeCount(0), stopping(false), failed(false) {
+}
+
+// Destructor: write out whatever is still buffered and stop the writer thread.
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+}
+
+// Open the file and start the background writer.
+bool AsyncFileWriter::open(const char* fileName) {
+    close();                      // Finish any previous file first
+
+    fd = ::open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    ownsFd = true;
+    start();
+    return true;
+}
+
+// Write to a descriptor the caller owns.
+void AsyncFileWriter::attach(int descriptor) {
+    close();
+    fd = descriptor;
+    ownsFd = false;
+    start();
+}
+
+// Set up the buffers and start the background writer with every buffer but the first free.
+void AsyncFileWriter::start() {
+    if (!storage) {
+        storage.reset(new char[BUFFER_COUNT * bufferSize]); // Allocated once, reused by later opens
+    }
+    currentIndex = 0;
+    current = storage.get();
+    used = 0;
+    pendingHead = 0;
+    pendingCount = 0;
+    freeCount = 0;
+    for (size_t i = 1; i < BUFFER_COUNT; i++) {
+        freeIndex[freeCount++] = i;
+    }
+    stopping = false;
+    failed = false;
+    writer = std::thread(&AsyncFileWriter::writerLoop, this);
+}
+
+// Background thread: write queued buffers in order until close() asks it to stop.
+void AsyncFileWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        bufferQueued.wait(lock, [this] { return pendingCount > 0 || stopping; });
+        if (pendingCount == 0) {
+            return;               // Stopping, and everything has been written
+        }
+        size_t index = pendingIndex[pendingHead];
+        size_t length = pendingLength[pendingHead];
+        bool skip = failed;       // After a failed write the rest of the output is dropped
+        lock.unlock();            // Write without holding the lock, so the caller keeps appending
+        bool ok = skip || writeFully(fd, storage.get() + index * bufferSize, length, -1);
+        lock.lock();
+        pendingHead = (pendingHead + 1) % BUFFER_COUNT;
+        pendingCount--;
+        freeIndex[freeCount++] = index;
+        failed = failed || !ok;
+        bufferWritten.notify_all();
+    }
+}
+
+// Queue the current buffer for writing and continue in a free one.
+void AsyncFileWriter::submit() {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t slot = (pendingHead + pendingCount) % BUFFER_COUNT;
+    pendingIndex[slot] = currentIndex;
+    pendingLength[slot] = used;
+    pendingCount++;
+    bufferQueued.notify_one();
+    bufferWritten.wait(lock, [this] { return freeCount > 0; }); // Blocks only if the disk is behind
+    currentIndex = freeIndex[--freeCount];
+    current = storage.get() + currentIndex * bufferSize;
+    used = 0;
+}
+
+// Append more than fits in the current buffer: fill it, submit it, and go on.
+void AsyncFileWriter::writeSlow(const char* data, size_t length) {
+    while (length > 0) {
+        if (used == bufferSize) {
+            submit();
+        }
+        size_t chunk = (length < bufferSize - used) ? length : bufferSize - used;
+        memcpy(current + used, data, chunk);
+        used += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+// Hand over the partly filled buffer, if it holds anything, and go on.
+void AsyncFileWriter::submitPartial() {
+    if (fd >= 0 && used > 0) {
+        submit();
+    }
+}
+
+// Hand over the partly filled buffer and wait until every buffer is back.
+void AsyncFileWriter::flush() {
+    if (fd < 0) {
+        return;
+    }
+    if (used > 0) {
+        submit();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    bufferWritten.wait(lock, [this] { return pendingCount == 0; });
+}
+
+// Overwrite bytes that have already been written (after flushing everything before them).
+bool AsyncFileWriter::writeAt(unsigned long long offset, const char* data, size_t length) {
+    if (fd < 0) {
+        return false;
+    }
+    flush();
+    std::lock_guard<std::mutex> lock(mutex);
+    failed = failed || !writeFully(fd, data, length, (long long)offset);
+    return !failed;
+}
+
+// Flush, stop the writer thread and close the descriptor (if it was opened here).
+bool AsyncFileWriter::close() {
+    if (fd < 0) {
+        return true;
+    }
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    bufferQueued.notify_one();
+    writer.join();
+    bool closed = !ownsFd || ::close(fd) == 0;
+    fd = -1;
+    current = nullptr;
+    used = 0;
+    return closed && !failed;
+}
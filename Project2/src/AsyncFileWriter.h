@@ -0,0 +1,130 @@
+#ifndef ASYNCFILEWRITER_H
+#define ASYNCFILEWRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "DSStringView.h"
+
+// Buffered file output with the writes done on a background thread.
+// The caller appends into one of a few large buffers; a full buffer is handed to the
+// writer thread, which writes it to the file while the caller fills the next one, so
+// disk I/O overlaps with whatever produces the output. The buffers are allocated once
+// per writer and reused, and appending (including integer formatting) never allocates.
+// Bytes reach the file in the order they were appended.
+class AsyncFileWriter {
+private:
+    static const size_t BUFFER_COUNT = 3;
+
+    int fd;                       // the open file (-1 when closed)
+    bool ownsFd;                  // close() closes fd (false for attach())
+    size_t bufferSize;
+    std::unique_ptr<char[]> storage; // BUFFER_COUNT buffers of bufferSize bytes each (not zeroed)
+    char* current;                // the buffer being filled by the caller
+    size_t currentIndex;
+    size_t used;                  // bytes appended to 'current'
+
+    // Shared with the writer thread, guarded by 'mutex'.
+    size_t pendingIndex[BUFFER_COUNT];   // full buffers waiting to be written, oldest first
+    size_t pendingLength[BUFFER_COUNT];
+    size_t pendingHead;
+    size_t pendingCount;
+    size_t freeIndex[BUFFER_COUNT];      // written buffers ready to be filled again
+    size_t freeCount;
+    bool stopping;
+    bool failed;                  // a write failed; later bytes are dropped
+    std::mutex mutex;
+    std::condition_variable bufferQueued;    // signalled when a buffer is queued or on close
+    std::condition_variable bufferWritten;   // signalled when the writer thread frees a buffer
+    std::thread writer;
+
+    void start();                 // allocates the buffers (once) and starts the writer thread
+    void writerLoop();
+    void submit();                // queues 'current' and waits for a free buffer
+    void writeSlow(const char* data, size_t length);
+
+    // Not copyable.
+    AsyncFileWriter(const AsyncFileWriter&);
+    AsyncFileWriter& operator=(const AsyncFileWriter&);
+public:
+    static const size_t DEFAULT_BUFFER_SIZE = 1 << 20; // 1 MiB
+
+    explicit AsyncFileWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    // Closes the file (see close()).
+    ~AsyncFileWriter();
+
+    // Creates or truncates the file and starts the writer thread. Returns false if the
+    // file cannot be opened. The append functions below require an open writer.
+    bool open(const char* fileName);
+
+    // Writes to an already open descriptor (e.g. standard output) instead of a file, at
+    // its current position. close() leaves the descriptor open.
+    void attach(int descriptor);
+
+    bool isOpen() const { return fd >= 0; }
+
+    void write(const char* data, size_t length) {
+        if (length <= bufferSize - used) {
+            memcpy(current + used, data, length);
+            used += length;
+        } else {
+            writeSlow(data, length);
+        }
+    }
+    void write(const DSStringView& text) { write(text.data(), text.length()); }
+
+    void put(char c) {
+        if (used == bufferSize) {
+            submit();
+        }
+        current[used++] = c;
+    }
+
+    // Writes 'value' in decimal to out[0 ..) and returns the number of characters
+    // (at most MAX_INT_LENGTH).
+    static const size_t MAX_INT_LENGTH = 20;
+    static size_t formatInt(long long value, char* out) {
+        unsigned long long magnitude = (value < 0) ? 0ull - (unsigned long long)value : (unsigned long long)value;
+        char reversed[MAX_INT_LENGTH];
+        size_t count = 0;
+        do {
+            reversed[count++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        size_t length = 0;
+        if (value < 0) {
+            out[length++] = '-';
+        }
+        while (count > 0) {
+            out[length++] = reversed[--count];
+        }
+        return length;
+    }
+
+    // Appends a number in decimal, as std::ostream would.
+    void writeInt(long long value) {
+        char digits[MAX_INT_LENGTH];
+        write(digits, formatInt(value, digits));
+    }
+
+    // Hands what has been appended so far to the writer thread without waiting for it to
+    // be written (it only waits if every buffer is still queued).
+    void submitPartial();
+
+    // Waits until everything appended so far has been written to the file.
+    void flush();
+
+    // Flushes, then overwrites 'length' bytes at 'offset' in the file (which must be
+    // seekable), e.g. to fill in a placeholder header. Returns false on error.
+    bool writeAt(unsigned long long offset, const char* data, size_t length);
+
+    // Flushes, stops the writer thread and closes the file. Returns false if any write
+    // failed. Does nothing if the writer is not open.
+    bool close();
+};
+
+#endif // ASYNCFILEWRITER_H
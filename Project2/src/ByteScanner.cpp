@@ -0,0 +1,296 @@
+#include "ByteScanner.h"      // Include the header file for the ByteScanner class
+#include <atomic>             // Include atomic for the pointer to the kernels in use
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>        // Include the SSE2 and AVX2 intrinsics
+#define BYTESCANNER_X86 1     // Build the vector kernels (AVX2 ones via per-function target attributes)
+#endif
+
+// ASCII character classes, as in the "C" locale.
+static inline bool isAsciiAlnum(unsigned char c) {
+    return (unsigned char)(c - '0') < 10 || (unsigned char)((c | 0x20) - 'a') < 26;
+}
+
+static inline bool isAsciiSpace(unsigned char c) {
+    return c == ' ' || (unsigned char)(c - '\t') < 5;   // '\t', '\n', '\v', '\f', '\r'
+}
+
+static inline unsigned char asciiLower(unsigned char c) {
+    return ((unsigned char)(c - 'A') < 26) ? (unsigned char)(c | 0x20) : c;
+}
+
+// Index of the lowest set bit (x != 0).
+static inline unsigned lowestBit(uint64_t x) {
+    return (unsigned)__builtin_ctzll(x);
+}
+
+// ---- Scalar kernels (also used for the tails the vector kernels leave) ----
+
+static size_t findScalar(const char* data, size_t length, char byte) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == byte) {
+            return i;
+        }
+    }
+    return length;
+}
+
+static void toLowerScalar(const char* in, char* out, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (char)asciiLower((unsigned char)in[i]);
+    }
+}
+
+// Fill mask words from byte 'start' (a multiple of 64) to the end of the input.
+static void classifyScalarFrom(const char* in, size_t start, size_t length, uint64_t* alnumMasks, uint64_t* spaceMasks) {
+    for (size_t base = start; base < length; base += 64) {
+        size_t end = (length - base < 64) ? length : base + 64;
+        uint64_t alnum = 0;
+        uint64_t space = 0;
+        for (size_t i = base; i < end; i++) {
+            unsigned char c = (unsigned char)in[i];
+            alnum |= (uint64_t)isAsciiAlnum(c) << (i - base);
+            space |= (uint64_t)isAsciiSpace(c) << (i - base);
+        }
+        alnumMasks[base / 64] = alnum;
+        spaceMasks[base / 64] = space;
+    }
+}
+
+static void matchScalarFrom(const char* in, size_t start, size_t length, char byte, uint64_t* masks) {
+    for (size_t base = start; base < length; base += 64) {
+        size_t end = (length - base < 64) ? length : base + 64;
+        uint64_t mask = 0;
+        for (size_t i = base; i < end; i++) {
+            mask |= (uint64_t)(in[i] == byte) << (i - base);
+        }
+        masks[base / 64] = mask;
+    }
+}
+
+static void classifyScalar(const char* in, size_t length, uint64_t* alnumMasks, uint64_t* spaceMasks) {
+    classifyScalarFrom(in, 0, length, alnumMasks, spaceMasks);
+}
+
+static void matchScalar(const char* in, size_t length, char byte, uint64_t* masks) {
+    matchScalarFrom(in, 0, length, byte, masks);
+}
+
+#ifdef BYTESCANNER_X86
+
+// ---- SSE2 kernels: 16 bytes per step ----
+
+// 0xFF in every lane whose byte lies in [lo, hi] (unsigned).
+static inline __m128i inRange16(__m128i c, char lo, char hi) {
+    __m128i x = _mm_sub_epi8(c, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8((char)(hi - lo))), x);
+}
+
+static inline __m128i alnum16(__m128i c) {
+    return _mm_or_si128(inRange16(c, '0', '9'), inRange16(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z'));
+}
+
+static inline __m128i space16(__m128i c) {
+    return _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), inRange16(c, '\t', '\r'));
+}
+
+static size_t findSSE2(const char* data, size_t length, char byte) {
+    __m128i needle = _mm_set1_epi8(byte);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+        unsigned bits = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (bits != 0) {
+            return i + lowestBit(bits);
+        }
+    }
+    return i + findScalar(data + i, length - i, byte);
+}
+
+static void toLowerSSE2(const char* in, char* out, size_t length) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i upper = inRange16(c, 'A', 'Z');
+        _mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(c, _mm_and_si128(upper, _mm_set1_epi8(0x20))));
+    }
+    toLowerScalar(in + i, out + i, length - i);
+}
+
+// Movemask of four 16-byte lanes as one 64-bit mask.
+static inline uint64_t combine16(__m128i a, __m128i b, __m128i c, __m128i d) {
+    return (uint64_t)(unsigned)_mm_movemask_epi8(a)
+         | (uint64_t)(unsigned)_mm_movemask_epi8(b) << 16
+         | (uint64_t)(unsigned)_mm_movemask_epi8(c) << 32
+         | (uint64_t)(unsigned)_mm_movemask_epi8(d) << 48;
+}
+
+static void classifySSE2(const char* in, size_t length, uint64_t* alnumMasks, uint64_t* spaceMasks) {
+    size_t base = 0;
+    for (; base + 64 <= length; base += 64) {
+        __m128i c0 = _mm_loadu_si128((const __m128i*)(in + base));
+        __m128i c1 = _mm_loadu_si128((const __m128i*)(in + base + 16));
+        __m128i c2 = _mm_loadu_si128((const __m128i*)(in + base + 32));
+        __m128i c3 = _mm_loadu_si128((const __m128i*)(in + base + 48));
+        alnumMasks[base / 64] = combine16(alnum16(c0), alnum16(c1), alnum16(c2), alnum16(c3));
+        spaceMasks[base / 64] = combine16(space16(c0), space16(c1), space16(c2), space16(c3));
+    }
+    classifyScalarFrom(in, base, length, alnumMasks, spaceMasks);
+}
+
+static void matchSSE2(const char* in, size_t length, char byte, uint64_t* masks) {
+    __m128i needle = _mm_set1_epi8(byte);
+    size_t base = 0;
+    for (; base + 64 <= length; base += 64) {
+        masks[base / 64] = combine16(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(in + base)), needle),
+                                     _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(in + base + 16)), needle),
+                                     _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(in + base + 32)), needle),
+                                     _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(in + base + 48)), needle));
+    }
+    matchScalarFrom(in, base, length, byte, masks);
+}
+
+// ---- AVX2 kernels: 32 bytes per step, compiled for AVX2 whatever the build flags ----
+
+#define BYTESCANNER_AVX2 __attribute__((target("avx2")))
+
+BYTESCANNER_AVX2 static inline __m256i inRange32(__m256i c, char lo, char hi) {
+    __m256i x = _mm256_sub_epi8(c, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8((char)(hi - lo))), x);
+}
+
+BYTESCANNER_AVX2 static inline __m256i alnum32(__m256i c) {
+    return _mm256_or_si256(inRange32(c, '0', '9'), inRange32(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 'z'));
+}
+
+BYTESCANNER_AVX2 static inline __m256i space32(__m256i c) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')), inRange32(c, '\t', '\r'));
+}
+
+BYTESCANNER_AVX2 static inline uint64_t combine32(__m256i low, __m256i high) {
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(low) | (uint64_t)(uint32_t)_mm256_movemask_epi8(high) << 32;
+}
+
+BYTESCANNER_AVX2 static size_t findAVX2(const char* data, size_t length, char byte) {
+    __m256i needle = _mm256_set1_epi8(byte);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        uint32_t bits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+        if (bits != 0) {
+            return i + lowestBit(bits);
+        }
+    }
+    return i + findSSE2(data + i, length - i, byte);
+}
+
+BYTESCANNER_AVX2 static void toLowerAVX2(const char* in, char* out, size_t length) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i upper = inRange32(c, 'A', 'Z');
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_or_si256(c, _mm256_and_si256(upper, _mm256_set1_epi8(0x20))));
+    }
+    toLowerSSE2(in + i, out + i, length - i);
+}
+
+BYTESCANNER_AVX2 static void classifyAVX2(const char* in, size_t length, uint64_t* alnumMasks, uint64_t* spaceMasks) {
+    size_t base = 0;
+    for (; base + 64 <= length; base += 64) {
+        __m256i low = _mm256_loadu_si256((const __m256i*)(in + base));
+        __m256i high = _mm256_loadu_si256((const __m256i*)(in + base + 32));
+        alnumMasks[base / 64] = combine32(alnum32(low), alnum32(high));
+        spaceMasks[base / 64] = combine32(space32(low), space32(high));
+    }
+    classifyScalarFrom(in, base, length, alnumMasks, spaceMasks);
+}
+
+BYTESCANNER_AVX2 static void matchAVX2(const char* in, size_t length, char byte, uint64_t* masks) {
+    __m256i needle = _mm256_set1_epi8(byte);
+    size_t base = 0;
+    for (; base + 64 <= length; base += 64) {
+        masks[base / 64] = combine32(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(in + base)), needle),
+                                     _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(in + base + 32)), needle));
+    }
+    matchScalarFrom(in, base, length, byte, masks);
+}
+
+#endif // BYTESCANNER_X86
+
+// One set of kernels per level.
+struct ScanKernels {
+    ByteScanner::Level level;
+    size_t (*find)(const char*, size_t, char);
+    void (*toLower)(const char*, char*, size_t);
+    void (*classify)(const char*, size_t, uint64_t*, uint64_t*);
+    void (*match)(const char*, size_t, char, uint64_t*);
+};
+
+static const ScanKernels kernelTable[] = {
+    { ByteScanner::SCALAR, findScalar, toLowerScalar, classifyScalar, matchScalar },
+#ifdef BYTESCANNER_X86
+    { ByteScanner::SSE2, findSSE2, toLowerSSE2, classifySSE2, matchSSE2 },
+    { ByteScanner::AVX2, findAVX2, toLowerAVX2, classifyAVX2, matchAVX2 },
+#endif
+};
+
+// The kernels in use; null until the first call picks the best supported ones.
+// Constant-initialized, so it is valid even during static initialization.
+static std::atomic<const ScanKernels*> activeKernels(nullptr);
+
+static const ScanKernels& kernels() {
+    const ScanKernels* active = activeKernels.load(std::memory_order_acquire);
+    if (active == nullptr) {
+        active = &kernelTable[ByteScanner::supportedLevel()];  // Every thread picks the same
+        activeKernels.store(active, std::memory_order_release);
+    }
+    return *active;
+}
+
+ByteScanner::Level ByteScanner::supportedLevel() {
+#ifdef BYTESCANNER_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SSE2;
+    }
+#endif
+    return SCALAR;
+}
+
+ByteScanner::Level ByteScanner::level() {
+    return kernels().level;
+}
+
+ByteScanner::Level ByteScanner::setLevel(Level level) {
+    if (level > supportedLevel()) {
+        level = supportedLevel();
+    }
+    activeKernels.store(&kernelTable[level], std::memory_order_release);
+    return level;
+}
+
+const char* ByteScanner::levelName(Level level) {
+    switch (level) {
+        case AVX2: return "avx2";
+        case SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+size_t ByteScanner::find(const char* data, size_t length, char byte) {
+    return kernels().find(data, length, byte);
+}
+
+void ByteScanner::toLower(const char* in, char* out, size_t length) {
+    kernels().toLower(in, out, length);
+}
+
+void ByteScanner::classify(const char* in, size_t length, uint64_t* alnumMasks, uint64_t* spaceMasks) {
+    kernels().classify(in, length, alnumMasks, spaceMasks);
+}
+
+void ByteScanner::match(const char* in, size_t length, char byte, uint64_t* masks) {
+    kernels().match(in, length, byte, masks);
+}
@@ -0,0 +1,49 @@
+#ifndef BYTESCANNER_H
+#define BYTESCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte-scanning kernels for the text hot paths, with SSE2 and AVX2 versions on x86
+// and a portable scalar version everywhere. The fastest version the CPU supports is
+// picked at runtime (the first time any kernel runs); all versions give identical
+// results. Character classes are plain ASCII, exactly like the <cctype> functions
+// in the "C" locale: bytes >= 0x80 are never letters, digits or spaces.
+//
+// Bit masks hold one bit per input byte: bit (i % 64) of masks[i / 64] describes
+// byte i, and the bits past 'length' in the last word are zero.
+class ByteScanner {
+public:
+    enum Level {
+        SCALAR = 0,
+        SSE2 = 1,
+        AVX2 = 2
+    };
+
+    // Index of the first occurrence of 'byte' in data[0 .. length), or length if none.
+    static size_t find(const char* data, size_t length, char byte);
+
+    // Writes the ASCII-lowercase form of in[0 .. length) to out (in == out is allowed).
+    static void toLower(const char* in, char* out, size_t length);
+
+    // Sets the mask bits of the letters and digits (alnum) and of the whitespace bytes
+    // ' ', '\t', '\n', '\v', '\f', '\r' (space) of in[0 .. length).
+    static void classify(const char* in, size_t length, uint64_t* alnumMasks, uint64_t* spaceMasks);
+
+    // Sets the mask bits of the bytes equal to 'byte'.
+    static void match(const char* in, size_t length, char byte, uint64_t* masks);
+
+    // Number of 64-bit mask words needed for 'length' bytes.
+    static size_t maskWords(size_t length) { return (length + 63) / 64; }
+
+    // The kernels in use, and the best ones this CPU supports.
+    static Level level();
+    static Level supportedLevel();
+    static const char* levelName(Level level);
+
+    // Switches to the given kernels (clamped to supportedLevel()); returns the level now
+    // in use. Meant for benchmarks and checks; must not race with running kernels.
+    static Level setLevel(Level level);
+};
+
+#endif // BYTESCANNER_H
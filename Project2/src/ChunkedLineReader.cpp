@@ -0,0 +1,73 @@
+#include "ChunkedLineReader.h"   // Include the header file for the ChunkedLineReader class
+#include <cstring>                   // Include cstring for memchr() and memmove()
+#include <iostream>                  // Include iostream for error messages (std::cerr)
+
+// Constructor: allocate the fixed chunk buffer once
+ChunkedLineReader::ChunkedLineReader(size_t chunkSize)
+    : buffer(chunkSize > 0 ? chunkSize : 1), begin(0), end(0), eof(false), bytesConsumed(0) {
+}
+
+// Open the file to stream and reset the buffer state
+bool ChunkedLineReader::open(const char* filename) {
+    in.close();
+    in.clear();
+    in.open(filename, std::ios::in | std::ios::binary);
+    begin = 0;
+    end = 0;
+    eof = false;
+    bytesConsumed = 0;
+    if (!in) {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        eof = true;
+        return false;
+    }
+    return true;
+}
+
+// Keep the partial line at the front of the buffer and fill the rest from the file
+void ChunkedLineReader::refill() {
+    size_t pending = end - begin;    // Bytes of the current (incomplete) line
+    if (begin > 0 && pending > 0) {
+        memmove(&buffer[0], &buffer[begin], pending); // Slide the partial line to the front
+    }
+    begin = 0;
+    end = pending;
+    if (end == buffer.size()) {      // One line fills the whole buffer: grow it so the line fits
+        buffer.resize(buffer.size() * 2);
+    }
+    in.read(&buffer[end], (std::streamsize)(buffer.size() - end)); // Read the next chunk
+    end += (size_t)in.gcount();
+    if (!in) {                       // Short read: the file is exhausted
+        eof = true;
+    }
+}
+
+// Hand out the next line as a view into the buffer (same splitting rules as std::getline)
+bool ChunkedLineReader::nextLine(DSStringView& line) {
+    while (true) {
+        const char* start = buffer.data() + begin;
+        const char* newline = (const char*)memchr(start, '\n', end - begin);
+        if (newline != nullptr) {    // A complete line is buffered
+            size_t lineLength = (size_t)(newline - start);
+            line = DSStringView(start, lineLength);
+            begin += lineLength + 1;
+            bytesConsumed += lineLength + 1;
+            return true;
+        }
+        if (eof) {                   // No more data: the rest (if any) is the final unterminated line
+            if (begin == end) {
+                return false;
+            }
+            line = DSStringView(start, end - begin);
+            bytesConsumed += end - begin;
+            begin = end;
+            return true;
+        }
+        refill();                    // Need more bytes to complete the line
+    }
+}
+
+// Number of file bytes consumed so far
+unsigned long long ChunkedLineReader::bytesRead() const {
+    return bytesConsumed;
+}
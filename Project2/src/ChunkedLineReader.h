@@ -0,0 +1,39 @@
+#ifndef CHUNKEDLINEREADER_H
+#define CHUNKEDLINEREADER_H
+
+#include <cstddef>
+#include <fstream>
+#include <vector>
+#include "DSStringView.h"
+
+// Reads a file of any size line by line through one fixed-size buffer.
+// Memory use is bounded by the chunk size (or the longest line, if that is
+// larger), not by the file size, so files far larger than RAM can be streamed.
+class ChunkedLineReader {
+private:
+    std::ifstream in;          // the file being streamed
+    std::vector<char> buffer;  // holds the current chunk plus any partial line carried over
+    size_t begin;              // first unconsumed byte in buffer
+    size_t end;                // one past the last valid byte in buffer
+    bool eof;                  // true once the whole file has been read into buffer
+    unsigned long long bytesConsumed; // bytes handed out as lines so far (including newlines)
+
+    // Moves the unconsumed tail to the front of the buffer and reads the next chunk after it.
+    void refill();
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 1 << 20; // 1 MiB
+
+    explicit ChunkedLineReader(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Opens the file to stream. Returns false if it cannot be opened.
+    bool open(const char* filename);
+
+    // Stores the next line (without its '\n') in 'line' and returns true, or returns
+    // false at the end of the file. The view is only valid until the next call.
+    bool nextLine(DSStringView& line);
+
+    // Number of file bytes consumed so far.
+    unsigned long long bytesRead() const;
+};
+
+#endif // CHUNKEDLINEREADER_H
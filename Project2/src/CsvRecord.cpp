@@ -0,0 +1,52 @@
+#include "CsvRecord.h"  // Include the header file for the CsvRecord class
+#include <cstring>      // Include cstring for memchr()
+
+// Split one line into fields, honouring quoted fields
+void CsvRecord::parse(const DSStringView& line) {
+    text = line;
+    fields.clear();                   // Reuse the vector (keeps its capacity)
+    const char* p = line.data();
+    size_t length = line.length();
+    size_t position = 0;              // Start of the current field
+    while (true) {
+        CsvField field;
+        size_t next = length;         // Where the field's delimiter is (length: none)
+        bool quoted = false;
+        if (position < length && p[position] == '"') {
+            // Quoted field: find the closing quote, stepping over doubled ones.
+            size_t i = position + 1;
+            size_t close = length;    // An unterminated quote runs to the end of the line
+            while (i < length) {
+                const char* quote = (const char*)memchr(p + i, '"', length - i);
+                if (quote == nullptr) {
+                    break;
+                }
+                size_t j = (size_t)(quote - p);
+                if (j + 1 < length && p[j + 1] == '"') {
+                    i = j + 2;        // "" is an escaped quote inside the value
+                    continue;
+                }
+                close = j;
+                break;
+            }
+            if (close == length || close + 1 == length || p[close + 1] == ',') {
+                quoted = true;
+                field.offset = position + 1;
+                field.length = close - field.offset;
+                next = (close < length) ? close + 1 : length;
+            }
+            // Otherwise the field is malformed and falls through to the literal scan below.
+        }
+        if (!quoted) {
+            const char* comma = (const char*)memchr(p + position, ',', length - position);
+            next = (comma != nullptr) ? (size_t)(comma - p) : length;
+            field.offset = position;
+            field.length = next - position;
+        }
+        fields.push_back(field);
+        if (next >= length) {
+            return;                   // No delimiter after this field: it was the last one
+        }
+        position = next + 1;          // The next field begins after the comma
+    }
+}
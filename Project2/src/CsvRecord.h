@@ -0,0 +1,44 @@
+#ifndef CSVRECORD_H
+#define CSVRECORD_H
+
+#include <cstddef>
+#include <vector>
+#include "DSStringView.h"
+
+// Where one field lies inside its record. The value is the record's characters
+// [offset, offset + length), without the enclosing quotes of a quoted field.
+struct CsvField {
+    size_t offset;
+    size_t length;
+};
+
+// One parsed CSV record (RFC 4180 quoting): fields are separated by commas, and a
+// field that starts with a double quote runs to the matching closing quote, so it
+// may contain commas; a doubled quote inside it stands for one quote character.
+// Parsing only records field offsets into the record's own memory, so nothing is
+// copied and callers look at just the columns they need.
+//
+// Records are single lines, as everywhere else in this program (the readers and
+// trainParallel's range cuts are line-based), so a quoted field cannot span lines:
+// a quote left open runs to the end of the line. A quoted field followed by anything
+// other than a comma is malformed and taken literally, quotes included, up to the
+// next comma.
+class CsvRecord {
+private:
+    DSStringView text;               // the record being parsed (not owned)
+    std::vector<CsvField> fields;    // reused from record to record
+public:
+    // Parses 'line' (without its newline), replacing the previous record.
+    // The record refers to the line's memory, which must outlive it.
+    void parse(const DSStringView& line);
+
+    // Number of fields (a record always has at least one, possibly empty, field).
+    size_t size() const { return fields.size(); }
+
+    // Field i as a view into the record (escaped quotes are still doubled).
+    DSStringView operator[](size_t i) const {
+        return DSStringView(text.data() + fields[i].offset, fields[i].length);
+    }
+};
+
+#endif // CSVRECORD_H
@@ -1,38 +1,80 @@
 #include "DSString.h"  // Include the header file for the DSString class
+#include <cstring>     // Include cstring for memcpy() to copy character runs
 
 // Default constructor: creates an empty string
-DSString::DSString() : data(nullptr), len(0) {  // Initialize data pointer to nullptr and length to 0
-    data = new char[1];             // Allocate memory for one character (for the null terminator)
+DSString::DSString() : data(inlineBuffer), len(0), cap(INLINE_CAPACITY) { // An empty string uses the inline buffer
     data[0] = '\0';                 // Set the first (and only) character to the null terminator, representing an empty string
 }
 
 // Parameterized constructor: creates a DSString from a C-string
-DSString::DSString(const char* s) { // Constructor that initializes DSString with a C-string
+DSString::DSString(const char* s) : data(inlineBuffer), len(0), cap(INLINE_CAPACITY) { // Constructor that initializes DSString with a C-string
     size_t i = 0;                   // Initialize index counter i to 0
     while (s[i] != '\0') {          // Loop until the end of the C-string is reached
         i++;                      // Increment i to count the number of characters
     }
+    reserve(i);                   // Allocate only if the string does not fit inline
+    memcpy(data, s, i);           // Copy the characters of the C-string
     len = i;                      // Set the DSString length to the number of characters found
-    data = new char[len + 1];     // Allocate memory for the characters plus one extra for the null terminator
-    for (size_t j = 0; j < len; j++) { // Loop over each character index j from 0 to len-1
-        data[j] = s[j];           // Copy the j-th character from the input C-string to the DSString data array
-    }
     data[len] = '\0';             // Append a null terminator at the end of the DSString
 }
 
+// Length-bounded constructor: creates a DSString from the first n characters of s
+DSString::DSString(const char* s, size_t n) : data(inlineBuffer), len(0), cap(INLINE_CAPACITY) { // Used to copy a slice out of a larger buffer (e.g. a mapped file)
+    reserve(n);                   // The length is given, so no scan for a null terminator is needed
+    memcpy(data, s, n);           // Copy each of the n characters
+    len = n;
+    data[len] = '\0';             // Terminate the copy
+}
+
 // Copy constructor: deep copy
-DSString::DSString(const DSString& other) { // Copy constructor that creates a new DSString as a deep copy of another
+DSString::DSString(const DSString& other) : data(inlineBuffer), len(0), cap(INLINE_CAPACITY) { // Copy constructor that creates a new DSString as a deep copy of another
+    reserve(other.len);           // Short strings stay inline; longer ones get exactly enough heap space
+    memcpy(data, other.data, other.len + 1); // Copy the characters and the null terminator
     len = other.len;              // Copy the length from the other DSString
-    data = new char[len + 1];     // Allocate new memory for the copied string (including null terminator)
-    for (size_t i = 0; i < len; i++) { // Loop over each character in the other DSString
-        data[i] = other.data[i];  // Copy each character from the other DSString's data array
-    }
-    data[len] = '\0';             // Set the last element to the null terminator
+}
+
+// Move constructor: takes over the other string's buffer instead of copying it
+DSString::DSString(DSString&& other) noexcept : data(inlineBuffer), len(0), cap(INLINE_CAPACITY) {
+    takeFrom(other);
 }
 
 // Destructor: free allocated memory
 DSString::~DSString() {           // Destructor for DSString, called when an object is destroyed
-    delete[] data;              // Free the dynamically allocated memory for the data array
+    releaseHeap();              // Free the heap buffer, if there is one
+}
+
+// True while the characters live in the object's own inline buffer
+bool DSString::isInline() const {
+    return data == inlineBuffer;
+}
+
+// Free the heap buffer (if any) and point back at the empty inline buffer
+void DSString::releaseHeap() {
+    if (!isInline()) {
+        delete[] data;
+    }
+    data = inlineBuffer;
+    cap = INLINE_CAPACITY;
+    len = 0;
+    data[0] = '\0';
+}
+
+// Steal the contents of 'other' (whose inline characters must be copied, since they live
+// inside the other object), then leave 'other' as an empty string. Requires this to be empty.
+void DSString::takeFrom(DSString& other) {
+    if (other.isInline()) {
+        memcpy(inlineBuffer, other.inlineBuffer, other.len + 1);
+        data = inlineBuffer;
+        cap = INLINE_CAPACITY;
+    } else {
+        data = other.data;        // Take over the heap buffer
+        cap = other.cap;
+        other.data = other.inlineBuffer;
+        other.cap = INLINE_CAPACITY;
+    }
+    len = other.len;
+    other.len = 0;
+    other.data[0] = '\0';
 }
 
 // Assignment operator: ensure proper deep copy and self-assignment check
@@ -40,37 +82,75 @@ DSString& DSString::operator=(const DSString& other) { // Overloaded assignment
     if (this == &other)          // Check for self-assignment (i.e., assigning the object to itself)
         return *this;           // If self-assignment, return the current object without doing anything
 
-    delete[] data;              // Delete the current data to free memory and avoid a memory leak
-    len = other.len;            // Copy the length from the other DSString
-    data = new char[len + 1];   // Allocate new memory for the data array based on the new length
-    for (size_t i = 0; i < len; i++) { // Loop over each character index
-        data[i] = other.data[i]; // Copy each character from the other DSString
+    if (other.len > cap) {      // Only reallocate if the current buffer is too small
+        releaseHeap();
+        reserve(other.len);
     }
-    data[len] = '\0';           // Set the last character to the null terminator
+    memcpy(data, other.data, other.len + 1); // Copy the characters and the null terminator
+    len = other.len;            // Copy the length from the other DSString
     return *this;               // Return the current object by reference
 }
 
+// Move assignment operator: release our buffer and take over the other string's
+DSString& DSString::operator=(DSString&& other) noexcept {
+    if (this != &other) {
+        releaseHeap();
+        takeFrom(other);
+    }
+    return *this;
+}
+
 // Return the length of the string
 size_t DSString::length() const { // Function to return the length of the DSString
     return len;               // Return the stored length (number of characters)
 }
 
+// Return the number of characters that fit without reallocating
+size_t DSString::capacity() const {
+    return cap;
+}
+
 // Return the C-string (null-terminated character array)
 const char* DSString::c_str() const { // Function to return the internal C-string representation of DSString
     return data;              // Return the pointer to the data array containing the characters
 }
 
+// Make room for at least n characters (plus the null terminator)
+void DSString::reserve(size_t n) {
+    if (n <= cap)                 // Already big enough
+        return;
+    size_t newCap = cap * 2;      // Grow geometrically so repeated appends stay O(1) amortized
+    if (newCap < n)
+        newCap = n;
+    char* newData = new char[newCap + 1]; // Allocate the larger buffer
+    memcpy(newData, data, len + 1); // Copy the existing characters and the null terminator
+    if (!isInline())
+        delete[] data;            // Free the old heap buffer
+    data = newData;
+    cap = newCap;
+}
+
 // Append a single character to the string
 void DSString::append(char c) { // Function to append one character to the end of the DSString
-    char* newData = new char[len + 2]; // Allocate new memory for current length + 1 new char + 1 for null terminator
-    for (size_t i = 0; i < len; i++) { // Loop through each character of the existing string
-        newData[i] = data[i];   // Copy the existing characters into the new array
-    }
-    newData[len] = c;           // Append the new character at the position equal to the current length
-    newData[len + 1] = '\0';    // Append a null terminator at the end of the new array
-    delete[] data;              // Delete the old data array to free memory
-    data = newData;             // Update the data pointer to the new array
+    if (len == cap)             // Full: grow (doubling the capacity)
+        reserve(len + 1);
+    data[len] = c;              // Append the new character at the position equal to the current length
     len++;                      // Increment the length to account for the new character
+    data[len] = '\0';           // Keep the string null-terminated
+}
+
+// Append n characters from s (which may point into this string)
+void DSString::append(const char* s, size_t n) {
+    if (len + n > cap) {
+        bool inside = s >= data && s <= data + len; // reserve() frees the buffer s points into
+        size_t offset = inside ? (size_t)(s - data) : 0;
+        reserve(len + n);
+        if (inside)
+            s = data + offset;    // The same characters in the new buffer
+    }
+    memcpy(data + len, s, n);
+    len += n;
+    data[len] = '\0';
 }
 
 // Equality operator
@@ -98,17 +178,10 @@ bool DSString::operator<(const DSString& other) const { // Overloaded operator t
 
 // Concatenation operator: returns a new DSString that is the concatenation of the two strings
 DSString DSString::operator+(const DSString& other) const { // Overloaded '+' operator for concatenating DSString objects
-    size_t newLen = len + other.len; // Calculate the length of the concatenated string
-    char* newData = new char[newLen + 1]; // Allocate memory for the new concatenated string (+1 for null terminator)
-    for (size_t i = 0; i < len; i++) { // Copy the characters from the current string to the new array
-        newData[i] = data[i];     // Copy each character from the original DSString
-    }
-    for (size_t i = 0; i < other.len; i++) { // Copy the characters from the other string
-        newData[len + i] = other.data[i]; // Append each character from the other DSString after the current string's characters
-    }
-    newData[newLen] = '\0';       // Set the null terminator at the end of the new concatenated string
-    DSString result(newData);     // Create a new DSString object using the concatenated C-string
-    delete[] newData;             // Free the temporary memory allocated for newData
+    DSString result;              // Build the result in place
+    result.reserve(len + other.len); // One allocation at most, sized for both parts
+    result.append(data, len);     // Copy the characters of this string
+    result.append(other.data, other.len); // Append the characters of the other string
     return result;                // Return the new DSString object representing the concatenated string
 }
 
@@ -5,33 +5,54 @@
 
 class DSString {
 private:
-    char* data;   // dynamically allocated character array
+    // Strings of up to INLINE_CAPACITY characters (most tweet tokens) are stored in
+    // inlineBuffer inside the object and need no heap allocation at all.
+    static const size_t INLINE_CAPACITY = 15;
+
+    char* data;   // inlineBuffer, or a heap array of cap + 1 characters
     size_t len;   // cached length of the string
+    size_t cap;   // characters that fit without reallocating (excluding the null terminator)
+    char inlineBuffer[INLINE_CAPACITY + 1];
+
+    bool isInline() const;
+    void releaseHeap();            // frees a heap buffer and falls back to the inline buffer
+    void takeFrom(DSString& other); // steals other's contents, leaving it empty
 public:
     // Constructors
     DSString();                       // default constructor
     DSString(const char* s);          // parameterized constructor
+    DSString(const char* s, size_t n); // copies exactly n characters (s need not be null-terminated)
     DSString(const DSString& other);  // copy constructor
+    DSString(DSString&& other) noexcept; // move constructor
 
     // Destructor
     ~DSString();
 
-    // Assignment operator
+    // Assignment operators
     DSString& operator=(const DSString& other);
+    DSString& operator=(DSString&& other) noexcept;
 
     // Member functions
     size_t length() const;
+    size_t capacity() const;
     const char* c_str() const;
-    
-    // Append a single character to the string (used in tokenization)
+
+    // Makes room for at least n characters without further reallocation.
+    void reserve(size_t n);
+
+    // Append a single character to the string (used in tokenization).
+    // Capacity grows geometrically, so appending n characters costs O(n) overall.
     void append(char c);
 
+    // Append n characters from s, which may point into this string (a.append(a.c_str(), n)).
+    void append(const char* s, size_t n);
+
     // Overloaded operators
     bool operator==(const DSString& other) const;
 
     // Comparison operator for STL containers (lexicographical comparison)
     bool operator<(const DSString& other) const;
-    
+
     DSString operator+(const DSString& other) const;
 
     // Friend function for stream output
@@ -0,0 +1,54 @@
+#include "DSStringView.h"  // Include the header file for the DSStringView class
+
+// Return the view of at most n characters starting at pos (clamped to the end of this view)
+DSStringView DSStringView::substr(size_t pos, size_t n) const {
+    if (pos > len)                // A start past the end yields an empty view
+        pos = len;
+    if (n > len - pos)            // Clamp the length so the view never runs past the end
+        n = len - pos;
+    return DSStringView(ptr + pos, n);
+}
+
+// Copy the viewed characters into a new, owning DSString
+DSString DSStringView::toDSString() const {
+    return DSString(ptr, len);
+}
+
+// Equality operator: same length and same characters
+bool DSStringView::operator==(const DSStringView& other) const {
+    if (len != other.len)         // If lengths differ, the views cannot be equal
+        return false;
+    for (size_t i = 0; i < len; i++) { // Compare character by character
+        if (ptr[i] != other.ptr[i])
+            return false;
+    }
+    return true;
+}
+
+// Equality against a null-terminated C-string (e.g. a literal such as "4")
+bool DSStringView::operator==(const char* s) const {
+    size_t i = 0;
+    for (; i < len; i++) {        // Walk both strings while the view has characters left
+        if (s[i] == '\0' || s[i] != ptr[i])
+            return false;         // The C-string ended early or a character differs
+    }
+    return s[i] == '\0';          // Equal only if the C-string ends exactly here as well
+}
+
+// Less-than operator: lexicographical order by character, shorter prefix first
+bool DSStringView::operator<(const DSStringView& other) const {
+    size_t minLen = (len < other.len) ? len : other.len; // Compare the common prefix first
+    for (size_t i = 0; i < minLen; i++) {
+        if (ptr[i] < other.ptr[i])
+            return true;
+        if (ptr[i] > other.ptr[i])
+            return false;
+    }
+    return len < other.len;       // Equal prefixes: the shorter view is smaller
+}
+
+// Overloaded stream insertion operator: writes exactly length() characters
+std::ostream& operator<<(std::ostream& os, const DSStringView& view) {
+    os.write(view.ptr, view.len); // The view is not null-terminated, so write by length
+    return os;
+}
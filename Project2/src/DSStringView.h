@@ -0,0 +1,78 @@
+#ifndef DSSTRINGVIEW_H
+#define DSSTRINGVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include "DSString.h"
+
+// A non-owning view of a run of characters (pointer plus length).
+// The viewed memory (a DSString, a mapped file, ...) must outlive the view.
+// The characters are not null-terminated, so always use length().
+class DSStringView {
+private:
+    const char* ptr;  // first viewed character (not owned)
+    size_t len;       // number of viewed characters
+public:
+    // Constructors
+    DSStringView() : ptr(""), len(0) {}                      // empty view
+    DSStringView(const char* s, size_t n) : ptr(s), len(n) {} // view of n characters starting at s
+    DSStringView(const DSString& s) : ptr(s.c_str()), len(s.length()) {} // view of a whole DSString
+    DSStringView(const char* s) : ptr(s), len(strlen(s)) {}  // view of a null-terminated string
+
+    // Member functions
+    const char* data() const { return ptr; }
+    size_t length() const { return len; }
+    bool empty() const { return len == 0; }
+    char operator[](size_t i) const { return ptr[i]; }
+
+    // Returns the view of at most n characters starting at pos.
+    DSStringView substr(size_t pos, size_t n) const;
+
+    // Makes an owning copy of the viewed characters.
+    DSString toDSString() const;
+
+    // 32-bit hash of the viewed bytes: 8 bytes per step with a multiply-xorshift mix.
+    // Inline because it sits on the hot path of every term-table lookup.
+    uint32_t hash() const {
+        const uint64_t k = 0x9E3779B97F4A7C15ull;
+        uint64_t h = len * k;
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t word;
+            memcpy(&word, ptr + i, 8);
+            h = (h ^ word) * k;
+            h ^= h >> 29;
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, ptr + i, len - i);
+        h = (h ^ tail) * k;
+        h ^= h >> 32;           // Fold the well-mixed high bits into the low bits used for probing
+        h *= 0xD6E8FEB86659FD93ull;
+        h ^= h >> 32;
+        return (uint32_t)h;
+    }
+
+    // Overloaded operators
+    bool operator==(const DSStringView& other) const;
+    bool operator==(const char* s) const;
+    bool operator!=(const DSStringView& other) const { return !(*this == other); }
+
+    // Lexicographical comparison (same order as DSString::operator<)
+    bool operator<(const DSStringView& other) const;
+
+    // Friend function for stream output
+    friend std::ostream& operator<<(std::ostream& os, const DSStringView& view);
+};
+
+// Lets DSStringView be used as a key in std::unordered_map / std::unordered_set.
+namespace std {
+template <>
+struct hash<DSStringView> {
+    size_t operator()(const DSStringView& view) const { return view.hash(); }
+};
+}
+
+#endif // DSSTRINGVIEW_H
@@ -2,6 +2,7 @@
 #include <fstream>                // Include fstream for file input/output operations
 #include <iostream>               // Include iostream for console input/output (e.g., std::cerr)
 #include <string>                 // Include string to use std::string for temporary storage
+#include <cstring>                // Include cstring for memchr() to find line ends quickly
 
 // Definition of the static method readLines in the FileIO class.
 // This method reads all lines from the given file and returns a vector of DSString objects.
@@ -25,3 +26,34 @@ std::vector<DSString> FileIO::readLines(const char* filename) {
     infile.close();             // Close the file after reading all lines
     return lines;               // Return the vector containing all the lines as DSString objects
 }
+
+// Definition of the static method nextLine in the FileIO class.
+// Returns the next '\n'-terminated line of the buffer as a view, without copying it.
+bool FileIO::nextLine(const DSStringView& buffer, size_t& offset, DSStringView& line) {
+    size_t size = buffer.length();  // Total number of bytes in the buffer
+    if (offset >= size) {         // Nothing left: like std::getline, no empty line after a final '\n'
+        return false;
+    }
+    const char* start = buffer.data() + offset; // First character of this line
+    const char* newline = (const char*)memchr(start, '\n', size - offset); // Find the end of the line
+    size_t lineLength = (newline != nullptr) ? (size_t)(newline - start) : size - offset;
+    line = DSStringView(start, lineLength); // Hand out a view into the buffer
+    offset += lineLength + 1;     // Skip the line and its '\n' (past the end if the last line has none)
+    return true;
+}
+
+// Count the lines of a buffer: one per '\n', plus a final line without one
+size_t FileIO::countLines(const DSStringView& buffer) {
+    size_t lines = 0;
+    const char* position = buffer.data();
+    const char* end = buffer.data() + buffer.length();
+    while (position < end) {
+        const char* newline = (const char*)memchr(position, '\n', end - position);
+        lines++;                  // Every non-empty remainder starts a line
+        if (newline == nullptr) {
+            break;                // The last line has no '\n'
+        }
+        position = newline + 1;
+    }
+    return lines;
+}
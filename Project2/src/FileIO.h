@@ -3,11 +3,21 @@
 
 #include <vector>
 #include "DSString.h"
+#include "DSStringView.h"
 
 class FileIO {
 public:
     // Reads the entire file and returns a vector of DSString, one per line.
     static std::vector<DSString> readLines(const char* filename);
+
+    // Zero-copy line iteration over an in-memory buffer (e.g. a MappedFile).
+    // Stores the line starting at offset in 'line' (without its '\n'), advances
+    // offset past it and returns true; returns false once the buffer is exhausted.
+    // Lines are split exactly like std::getline, so both readers agree.
+    static bool nextLine(const DSStringView& buffer, size_t& offset, DSStringView& line);
+
+    // Number of lines nextLine() will return for the buffer (used to size tables up front).
+    static size_t countLines(const DSStringView& buffer);
 };
 
 #endif // FILEIO_H
@@ -0,0 +1,150 @@
+#include "GroundTruth.h"  // Include the header file for the ground-truth join classes
+#include "FileIO.h"       // Include FileIO for line iteration over the mapped file
+
+// Sentiment of a ground-truth line ("4" is positive, anything else negative).
+static int sentimentOf(const DSStringView& field) {
+    return (field == "4") ? 4 : 0;
+}
+
+// Parse a CSV field as a tweet ID: its value if it is a canonical decimal number.
+TweetId TweetId::parse(const DSStringView& field) {
+    TweetId id;
+    id.text = field;
+    id.value = 0;
+    size_t length = field.length();
+    id.numeric = length > 0 && length <= 20 && !(field[0] == '0' && length > 1);
+    for (size_t i = 0; id.numeric && i < length; i++) {
+        unsigned digit = (unsigned char)field[i] - '0';
+        id.numeric = digit <= 9;  // Not a digit: a text ID
+        if (i == 19 && id.value > (~(uint64_t)0 - digit) / 10) {
+            id.numeric = false;   // Only a 20th digit can overflow 64 bits
+        }
+        id.value = id.value * 10 + digit;
+    }
+    return id;
+}
+
+// Text IDs before numbers; then byte order or numeric order.
+bool TweetId::operator<(const TweetId& other) const {
+    if (numeric != other.numeric) {
+        return !numeric;
+    }
+    return numeric ? value < other.value : text < other.text;
+}
+
+// A canonical number has exactly one spelling, so comparing values compares the fields.
+bool TweetId::operator==(const TweetId& other) const {
+    if (numeric != other.numeric) {
+        return false;
+    }
+    return numeric ? value == other.value : text == other.text;
+}
+
+// Index every line of the ground-truth file by ID.
+void GroundTruthTable::load(const DSStringView& contents) {
+    numericIds.reserve(FileIO::countLines(contents));
+    CsvRecord fields;
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        fields.parse(line);
+        if (fields.size() < 2) {
+            continue;             // Not a sentiment, id line
+        }
+        TweetId id = TweetId::parse(fields[1]);
+        if (id.numeric) {
+            numericIds[id.value] = sentimentOf(fields[0]);
+        } else {
+            textIds[id.text] = sentimentOf(fields[0]);
+        }
+    }
+}
+
+// One integer probe for a numeric ID, one string probe otherwise.
+GroundTruthResult GroundTruthTable::lookup(const TweetId& id, int& sentiment) const {
+    const int* found = id.numeric ? numericIds.find(id.value) : textIds.find(id.text);
+    if (found == nullptr) {
+        return TRUTH_MISSING;
+    }
+    sentiment = *found;
+    return TRUTH_FOUND;
+}
+
+GroundTruthMerge::GroundTruthMerge()
+    : hasCurrent(false), currentSentiment(0), hasMatched(false), matchedResult(TRUTH_MISSING),
+      matchedSentiment(0), outOfOrder(false) {
+    current = TweetId::parse(DSStringView());
+    matched = current;
+}
+
+// Copy an ID so it survives the buffer it was read from (only text IDs point into it).
+void GroundTruthMerge::keep(const TweetId& id, TweetId& target, DSString& storage) {
+    target = id;
+    if (!id.numeric) {
+        storage = id.text.toDSString();
+        target.text = DSStringView(storage);
+    }
+}
+
+// Read the first ground-truth line.
+bool GroundTruthMerge::open(const char* fileName) {
+    hasCurrent = false;
+    hasMatched = false;
+    outOfOrder = false;
+    if (!reader.open(fileName)) {
+        return false;
+    }
+    advance();
+    return true;
+}
+
+// Step to the next line with at least two fields, checking that the IDs do not decrease.
+void GroundTruthMerge::advance() {
+    DSStringView line;
+    while (reader.nextLine(line)) {
+        fields.parse(line);
+        if (fields.size() < 2) {
+            continue;
+        }
+        TweetId id = TweetId::parse(fields[1]);
+        if (hasCurrent && id < current) {
+            outOfOrder = true;
+        }
+        keep(id, current, currentText);
+        currentSentiment = sentimentOf(fields[0]);
+        hasCurrent = true;
+        return;
+    }
+    hasCurrent = false;
+}
+
+// Skip the ground-truth lines before 'id', then take the last line for 'id', if any.
+GroundTruthResult GroundTruthMerge::lookup(const TweetId& id, int& sentiment) {
+    if (hasMatched && id == matched) {
+        // The same test ID again (its ground-truth lines are already consumed).
+        sentiment = matchedSentiment;
+        return matchedResult;
+    }
+    if (hasMatched && id < matched) {
+        outOfOrder = true;        // The test file is not sorted
+    }
+    while (!outOfOrder && hasCurrent && current < id) {
+        advance();
+    }
+    if (outOfOrder) {
+        return TRUTH_OUT_OF_ORDER;
+    }
+    matchedResult = TRUTH_MISSING;
+    while (hasCurrent && current == id) {
+        matchedResult = TRUTH_FOUND;
+        matchedSentiment = currentSentiment;
+        advance();                // A later line for the same ID overrides this one
+    }
+    if (outOfOrder) {
+        return TRUTH_OUT_OF_ORDER;
+    }
+    keep(id, matched, matchedText);
+    hasMatched = true;
+    sentiment = matchedSentiment;
+    return matchedResult;
+}
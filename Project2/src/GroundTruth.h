@@ -0,0 +1,87 @@
+#ifndef GROUNDTRUTH_H
+#define GROUNDTRUTH_H
+
+#include <cstdint>
+#include "ChunkedLineReader.h"
+#include "CsvRecord.h"
+#include "DSString.h"
+#include "DSStringView.h"
+#include "IntHashMap.h"
+#include "StringHashMap.h"
+
+// A tweet ID as read from a CSV field. IDs are 64-bit integers, so a field that is a
+// plain decimal number (no sign, no leading zeros, at most 2^64 - 1) is kept as its
+// value. Anything else (e.g. the "id" of a header line) is kept as its text. Two IDs
+// are equal exactly when their fields are byte-for-byte equal.
+struct TweetId {
+    bool numeric;
+    uint64_t value;     // if numeric
+    DSStringView text;  // the field itself (not owned)
+
+    static TweetId parse(const DSStringView& field);
+
+    // Sort order of the sorted ground-truth join: text IDs first, byte by byte, then
+    // numbers by value.
+    bool operator<(const TweetId& other) const;
+    bool operator==(const TweetId& other) const;
+};
+
+// Outcome of a ground-truth lookup.
+enum GroundTruthResult {
+    TRUTH_FOUND,
+    TRUTH_MISSING,
+    TRUTH_OUT_OF_ORDER   // a sorted join saw IDs out of order; the join cannot continue
+};
+
+// The whole ground-truth file (sentiment, id per line) in memory, for any order of the
+// test tweets. Numeric IDs go into a flat integer hash table; the rare other IDs into a
+// string hash map. A later line for the same ID overrides an earlier one.
+class GroundTruthTable {
+private:
+    IntHashMap<int> numericIds;
+    StringHashMap<int> textIds;
+public:
+    // Reads every line of the file contents.
+    void load(const DSStringView& contents);
+
+    size_t size() const { return numericIds.size() + textIds.size(); }
+
+    // Sets 'sentiment' and returns TRUTH_FOUND, or returns TRUTH_MISSING.
+    GroundTruthResult lookup(const TweetId& id, int& sentiment) const;
+};
+
+// Merge join against a ground-truth file sorted by ID (in TweetId order), for test
+// files sorted the same way. The file is streamed through a ChunkedLineReader and only
+// the current line is held, so memory does not depend on the file size. Lookups must
+// come in non-decreasing ID order; an ID smaller than the previous one, in either file,
+// makes the lookup return TRUTH_OUT_OF_ORDER. Results match GroundTruthTable's,
+// including a later line for an ID overriding an earlier one.
+class GroundTruthMerge {
+private:
+    ChunkedLineReader reader;
+    CsvRecord fields;
+    bool hasCurrent;             // 'current' holds the next unconsumed ground-truth line
+    TweetId current;
+    DSString currentText;        // owns current.text when it is not numeric
+    int currentSentiment;
+    bool hasMatched;             // 'matched' is the last ID looked up, with its result
+    TweetId matched;
+    DSString matchedText;
+    GroundTruthResult matchedResult;
+    int matchedSentiment;
+    bool outOfOrder;
+
+    // Reads the next usable ground-truth line into 'current'.
+    void advance();
+    static void keep(const TweetId& id, TweetId& target, DSString& storage);
+public:
+    GroundTruthMerge();
+
+    // Opens the sorted ground-truth file. Returns false if it cannot be opened.
+    bool open(const char* fileName);
+
+    // Sets 'sentiment' and returns TRUTH_FOUND, or returns TRUTH_MISSING or TRUTH_OUT_OF_ORDER.
+    GroundTruthResult lookup(const TweetId& id, int& sentiment);
+};
+
+#endif // GROUNDTRUTH_H
@@ -0,0 +1,119 @@
+#ifndef INTHASHMAP_H
+#define INTHASHMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash map from 64-bit integers to values of type V, for joins on
+// numeric IDs. Keys and values live in two flat arrays probed linearly, so a lookup is
+// one multiply and usually one cache line; there is no per-entry allocation and no
+// string hashing or comparing. The table doubles when it becomes half full.
+// Entries cannot be erased.
+template <typename V>
+class IntHashMap {
+private:
+    static const uint64_t EMPTY = ~(uint64_t)0;  // marks a free slot
+
+    std::vector<uint64_t> keys;  // slot -> key, or EMPTY
+    std::vector<V> values;       // slot -> value
+    size_t count;                // keys stored in the slots
+    unsigned shift;              // 64 - log2(slot count)
+    bool hasEmptyKey;            // the key equal to EMPTY is kept outside the table
+    V emptyKeyValue;
+
+    // Home slot of a key: the high bits of a multiplicative hash.
+    size_t slotOf(uint64_t key) const {
+        return (size_t)((key * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    // Slot holding 'key', or the free slot where it would go. Requires a non-empty table.
+    size_t probe(uint64_t key) const {
+        size_t mask = keys.size() - 1;
+        size_t i = slotOf(key);
+        while (keys[i] != key && keys[i] != EMPTY) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    // Move every entry into a table of 'slots' slots (a power of two).
+    void rehash(size_t slots) {
+        std::vector<uint64_t> oldKeys(slots, EMPTY);
+        std::vector<V> oldValues(slots);
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        shift = 64;
+        for (size_t s = slots; s > 1; s /= 2) {
+            shift--;
+        }
+        for (size_t i = 0; i < oldKeys.size(); i++) {
+            if (oldKeys[i] != EMPTY) {
+                size_t slot = probe(oldKeys[i]);
+                keys[slot] = oldKeys[i];
+                values[slot] = oldValues[i];
+            }
+        }
+    }
+public:
+    IntHashMap() : count(0), shift(64), hasEmptyKey(false), emptyKeyValue() {}
+
+    size_t size() const { return count + (hasEmptyKey ? 1 : 0); }
+    bool empty() const { return size() == 0; }
+
+    // Pointer to the value for 'key', or nullptr. Never modifies the map.
+    const V* find(uint64_t key) const {
+        if (key == EMPTY) {
+            return hasEmptyKey ? &emptyKeyValue : nullptr;
+        }
+        if (keys.empty()) {
+            return nullptr;
+        }
+        size_t slot = probe(key);
+        return (keys[slot] == key) ? &values[slot] : nullptr;
+    }
+
+    // Like std::map::operator[]: the value for 'key', inserted (value-initialized) if missing.
+    V& operator[](uint64_t key) {
+        if (key == EMPTY) {
+            hasEmptyKey = true;
+            return emptyKeyValue;
+        }
+        if (2 * (count + 1) > keys.size()) {
+            rehash(keys.empty() ? 16 : 2 * keys.size());
+        }
+        size_t slot = probe(key);
+        if (keys[slot] != key) {
+            keys[slot] = key;
+            values[slot] = V();
+            count++;
+        }
+        return values[slot];
+    }
+
+    // Make room for n keys without further growth.
+    void reserve(size_t n) {
+        size_t slots = 16;
+        while (slots < 2 * n) {
+            slots *= 2;
+        }
+        if (slots > keys.size()) {
+            rehash(slots);
+        }
+    }
+
+    void clear() {
+        keys.clear();
+        values.clear();
+        count = 0;
+        shift = 64;
+        hasEmptyKey = false;
+        emptyKeyValue = V();
+    }
+};
+
+// Definition of the constant, for the calls that bind it to a reference.
+template <typename V>
+const uint64_t IntHashMap<V>::EMPTY;
+
+#endif // INTHASHMAP_H
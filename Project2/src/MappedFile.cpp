@@ -0,0 +1,138 @@
+#include "MappedFile.h"       // Include the header file for the MappedFile class
+#include <cerrno>                 // Include cerrno to retry reads interrupted by a signal
+#include <iostream>               // Include iostream for error messages (std::cerr)
+#include <fcntl.h>                // Include fcntl.h for open()
+#include <sys/mman.h>             // Include sys/mman.h for mmap(), munmap() and madvise()
+#include <sys/stat.h>             // Include sys/stat.h for fstat() to learn the file size
+#include <unistd.h>               // Include unistd.h for close() and read()
+
+// Default constructor: nothing mapped yet
+MappedFile::MappedFile() : data(nullptr), size(0), mapped(false) {
+}
+
+// Constructor that maps the given file right away
+MappedFile::MappedFile(const char* filename, AccessPattern access) : data(nullptr), size(0), mapped(false) {
+    open(filename, access);
+}
+
+// Destructor: release the mapping
+MappedFile::~MappedFile() {
+    close();
+}
+
+// Map the whole file read-only into memory.
+bool MappedFile::open(const char* filename, AccessPattern access) {
+    close();                      // Drop any previous mapping first
+
+    int fd = ::open(filename, O_RDONLY); // Open the file for reading
+    if (fd < 0) {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        return false;
+    }
+
+    struct stat st;               // Ask the file system for the size of the file
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error: Unable to stat file " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    if (!S_ISREG(st.st_mode)) {   // Pipes and devices report no size and cannot be mapped
+        bool ok = readAll(fd);
+        ::close(fd);
+        if (!ok) {
+            std::cerr << "Error: Unable to read file " << filename << std::endl;
+        }
+        return ok;
+    }
+
+    if (st.st_size == 0) {        // mmap() rejects zero-length mappings; an empty file is simply empty
+        ::close(fd);
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);                  // The mapping stays valid after the descriptor is closed
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Unable to map file " << filename << std::endl;
+        return false;
+    }
+
+    // An input file is read front to back once, so let the kernel read ahead aggressively
+    // and drop pages behind us; this keeps training and evaluation I/O bound. A model is
+    // probed at random for as long as it is loaded, where read-ahead only wastes memory
+    // and dropping pages behind would fault them back in.
+    madvise(mapping, (size_t)st.st_size, (access == ACCESS_RANDOM) ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+    data = (const char*)mapping;
+    size = (size_t)st.st_size;
+    mapped = true;
+    return true;
+}
+
+// Read everything up to the end of 'fd' into the owned buffer, doubling it as it fills.
+bool MappedFile::readAll(int fd) {
+    std::vector<char> bytes(65536);
+    size_t length = 0;
+    for (;;) {
+        if (length == bytes.size()) {
+            bytes.resize(2 * bytes.size());
+        }
+        ssize_t received = read(fd, bytes.data() + length, bytes.size() - length);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0) {
+            return false;
+        }
+        if (received == 0) {
+            break;
+        }
+        length += (size_t)received;
+    }
+    bytes.resize(length);
+    buffer.swap(bytes);
+    data = buffer.empty() ? nullptr : buffer.data();
+    size = length;
+    return true;
+}
+
+// Unmap the file or free its buffer (if anything is open)
+void MappedFile::close() {
+    if (data != nullptr && mapped) {
+        munmap((void*)data, size);
+    }
+    std::vector<char>().swap(buffer);
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
+
+// Exchange the mappings of two objects
+void MappedFile::swap(MappedFile& other) {
+    const char* otherData = other.data;
+    size_t otherSize = other.size;
+    bool otherMapped = other.mapped;
+    other.data = data;
+    other.size = size;
+    other.mapped = mapped;
+    data = otherData;
+    size = otherSize;
+    mapped = otherMapped;
+    buffer.swap(other.buffer);    // Swapping vectors keeps their data pointers valid
+}
+
+const char* MappedFile::begin() const {
+    return data;
+}
+
+size_t MappedFile::length() const {
+    return size;
+}
+
+// The whole mapping as a view (empty if nothing is mapped)
+DSStringView MappedFile::view() const {
+    if (data == nullptr)
+        return DSStringView();
+    return DSStringView(data, size);
+}
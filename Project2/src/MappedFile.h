@@ -0,0 +1,52 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <vector>
+#include "DSStringView.h"
+
+// Read-only memory mapping of a whole file.
+// Lines and fields can be handed out as DSStringViews that point straight into
+// the mapping, so reading a file costs no copies and no per-line allocations.
+// Anything that is not a regular file (a pipe, /dev/stdin, a <(...) substitution)
+// cannot be mapped; it is read to its end into an owned buffer instead.
+class MappedFile {
+public:
+    // How the mapping will be read, passed to the kernel as a madvise() hint.
+    enum AccessPattern {
+        ACCESS_SEQUENTIAL,  // front to back once (input files): read ahead, drop pages behind
+        ACCESS_RANDOM       // scattered lookups that stay mapped (a model): no read-ahead
+    };
+private:
+    const char* data;  // start of the mapping or buffer (nullptr when nothing is open)
+    size_t size;       // number of mapped bytes
+    bool mapped;       // data comes from mmap (otherwise it points into 'buffer')
+    std::vector<char> buffer;  // the contents of a non-regular file
+
+    bool readAll(int fd);
+
+    // Not copyable: the mapping is owned by exactly one object.
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+public:
+    MappedFile();
+    explicit MappedFile(const char* filename, AccessPattern access = ACCESS_SEQUENTIAL);
+    ~MappedFile();
+
+    // Maps the given file, replacing any current mapping. Returns false on error.
+    bool open(const char* filename, AccessPattern access = ACCESS_SEQUENTIAL);
+
+    // Releases the mapping (or the buffer).
+    void close();
+
+    // Exchanges mappings with another MappedFile (used to hand a mapping over to a new owner).
+    void swap(MappedFile& other);
+
+    const char* begin() const;
+    size_t length() const;
+
+    // The whole file as a view.
+    DSStringView view() const;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,54 @@
+#ifndef MODELFORMAT_H
+#define MODELFORMAT_H
+
+#include <cstdint>
+
+// On-disk layout of a saved SentimentClassifier model (see SentimentClassifier::save/load).
+//
+// The file is the header below followed by five sections, each starting at the
+// 8-byte aligned offset recorded in the header:
+//   slots       slotCount       x StringHashSlot  (the term table's probe table)
+//   keyOffsets  termCount + 1   x uint32_t        (term i is keyPool[keyOffsets[i] .. keyOffsets[i + 1]))
+//   termStats   termCount       x TermStats       (positive, negative, documents)
+//   logRatios   termCount       x double          (per-term part of the log-likelihood ratio)
+//   keyPool     keyBytes        x char            (all term bytes back to back)
+// These are exactly the arrays predict reads, so load() maps the file and points the
+// classifier at the sections without parsing or copying them.
+// Values are stored in native byte order; 'byteOrder' rejects files from a machine of the
+// other endianness. Bump MODEL_VERSION whenever the layout or the meaning of a field changes.
+
+static const char MODEL_MAGIC[8] = { 'D', 'B', 'S', 'M', 'O', 'D', 'E', 'L' };
+static const uint32_t MODEL_VERSION = 3;  // 3: TermStats without training bookkeeping; 2: split log ratios
+static const uint32_t MODEL_BYTE_ORDER = 0x01020304u;
+
+struct ModelFileHeader {
+    char magic[8];                // MODEL_MAGIC
+    uint32_t version;             // MODEL_VERSION
+    uint32_t byteOrder;           // MODEL_BYTE_ORDER as written by the saving machine
+
+    // Training totals.
+    int64_t positiveTweetCount;
+    int64_t negativeTweetCount;
+    int64_t totalPositiveWords;
+    int64_t totalNegativeWords;
+    int64_t vocabularySize;
+
+    // Frozen scoring constants.
+    double logPriorRatio;
+    double tokenLogRatio;         // per-token part of every log-likelihood ratio
+
+    // Section sizes.
+    uint64_t termCount;
+    uint64_t slotCount;           // a power of two, or 0 for an empty model
+    uint64_t keyBytes;
+
+    // Section offsets from the start of the file, and the total file size.
+    uint64_t slotsOffset;
+    uint64_t keyOffsetsOffset;
+    uint64_t termStatsOffset;
+    uint64_t logRatiosOffset;
+    uint64_t keyPoolOffset;
+    uint64_t fileSize;
+};
+
+#endif // MODELFORMAT_H
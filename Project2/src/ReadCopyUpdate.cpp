@@ -0,0 +1,98 @@
+#include "ReadCopyUpdate.h"  // Include the header file for the ReadCopyUpdate class
+#include <atomic>                // Include atomic for the epochs shared between readers and writers
+#include <cstdint>               // Include cstdint for the 64-bit epoch counter
+#include <memory>                // Include memory for std::unique_ptr owning the reader slots
+#include <mutex>                 // Include mutex to guard the registry of reader slots
+#include <thread>                // Include thread for std::this_thread::yield() while waiting
+#include <vector>                // Include vector for the registry of reader slots
+
+// The epoch a reading thread's outermost guard started in, or 0 while it is not
+// reading. Padded to a cache line so readers on different cores do not contend.
+struct ReaderSlot {
+    std::atomic<uint64_t> epoch;
+    bool inUse;                   // owned by a live thread (guarded by registryMutex)
+    char padding[64 - sizeof(std::atomic<uint64_t>) - sizeof(bool)];
+
+    ReaderSlot() : epoch(0), inUse(true) {}
+};
+
+// Every slot ever created; slots are only freed at exit, and reused until then.
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<ReaderSlot> > registry;
+
+// Current epoch; synchronize() starts a new one. Starts at 1 so 0 can mean "not reading".
+static std::atomic<uint64_t> currentEpoch(1);
+
+// The calling thread's slot and guard nesting depth. The slot is taken on first use and
+// handed back when the thread exits.
+struct ThreadReader {
+    ReaderSlot* slot;
+    unsigned depth;
+
+    ThreadReader() : slot(nullptr), depth(0) {}
+    ~ThreadReader() {
+        if (slot != nullptr) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            slot->inUse = false;
+        }
+    }
+
+    // Reuse a slot a finished thread left behind, or add a new one.
+    void attach() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (size_t i = 0; i < registry.size(); i++) {
+            if (!registry[i]->inUse) {
+                registry[i]->inUse = true;
+                slot = registry[i].get();
+                return;
+            }
+        }
+        slot = new ReaderSlot();
+        registry.push_back(std::unique_ptr<ReaderSlot>(slot));
+    }
+};
+
+static thread_local ThreadReader threadReader;
+
+// Announce the epoch before reading: the seq_cst store orders it before the reader's
+// load of the published pointer, so a writer that does not see the slot yet has
+// already published, and this reader sees the new pointer.
+ReadCopyUpdate::ReadGuard::ReadGuard() {
+    ThreadReader& reader = threadReader;
+    if (reader.depth++ == 0) {
+        if (reader.slot == nullptr) {
+            reader.attach();
+        }
+        reader.slot->epoch.store(currentEpoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    }
+}
+
+// Done reading: the release store orders every read before it.
+ReadCopyUpdate::ReadGuard::~ReadGuard() {
+    ThreadReader& reader = threadReader;
+    if (--reader.depth == 0) {
+        reader.slot->epoch.store(0, std::memory_order_release);
+    }
+}
+
+// Start a new epoch, then wait for every slot that is still in an older one.
+void ReadCopyUpdate::synchronize() {
+    uint64_t target = currentEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    std::vector<ReaderSlot*> slots;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        // Wait without the lock, so new threads can still register.
+        for (size_t i = 0; i < registry.size(); i++) {
+            slots.push_back(registry[i].get());
+        }
+    }
+    for (size_t i = 0; i < slots.size(); i++) {
+        for (;;) {
+            uint64_t epoch = slots[i]->epoch.load(std::memory_order_seq_cst);
+            if (epoch == 0 || epoch >= target) {
+                break;            // Not reading, or started after the new pointer was published
+            }
+            std::this_thread::yield();
+        }
+    }
+}
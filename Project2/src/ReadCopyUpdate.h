@@ -0,0 +1,32 @@
+#ifndef READCOPYUPDATE_H
+#define READCOPYUPDATE_H
+
+// Read-copy-update: lets one thread replace data that other threads are reading
+// without ever blocking the readers. Readers hold a ReadGuard while they use the data,
+// reached through an atomic pointer loaded with std::memory_order_seq_cst. The writer
+// builds a new copy, stores the pointer to it, and calls synchronize(), which waits
+// until every guard that might still see the old copy is gone; the old copy can then
+// be freed.
+//
+// Each reading thread has one slot (registered on its first guard, reused after the
+// thread exits) holding the epoch in which its current outermost guard started, so
+// taking and dropping a guard costs two stores to the thread's own slot and never
+// allocates after the first time.
+class ReadCopyUpdate {
+public:
+    // Marks the calling thread as reading until destroyed. Guards nest.
+    class ReadGuard {
+    private:
+        ReadGuard(const ReadGuard&);
+        ReadGuard& operator=(const ReadGuard&);
+    public:
+        ReadGuard();
+        ~ReadGuard();
+    };
+
+    // Waits until every ReadGuard that existed when it was called has been destroyed.
+    // Must not be called while the calling thread holds a ReadGuard.
+    static void synchronize();
+};
+
+#endif // READCOPYUPDATE_H
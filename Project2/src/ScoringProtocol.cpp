@@ -0,0 +1,91 @@
+#include "ScoringProtocol.h"  // Include the header file for the scoring daemon's frame format
+#include <cstring>                // Include cstring for memcpy() of the length fields
+
+// Read a length field (fields are not aligned, so copy it out).
+static uint32_t readUint32(const char* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Append a length field.
+static void appendUint32(std::vector<char>& out, uint32_t value) {
+    const char* bytes = (const char*)&value;
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+// Check whether a whole frame has arrived.
+ScoringProtocol::FrameStatus ScoringProtocol::nextFrame(const char* data, size_t size, size_t& frameBytes) {
+    if (size < LENGTH_BYTES) {
+        return FRAME_INCOMPLETE;
+    }
+    uint32_t bodyBytes = readUint32(data);
+    if (bodyBytes > MAX_BODY_BYTES) {
+        return FRAME_INVALID;
+    }
+    if (size - LENGTH_BYTES < bodyBytes) {
+        return FRAME_INCOMPLETE;
+    }
+    frameBytes = LENGTH_BYTES + bodyBytes;
+    return FRAME_COMPLETE;
+}
+
+// Length, count, then each tweet with its own length.
+void ScoringProtocol::appendRequest(std::vector<char>& out, const DSStringView* tweets, size_t count) {
+    size_t bodyBytes = LENGTH_BYTES;
+    for (size_t i = 0; i < count; i++) {
+        bodyBytes += LENGTH_BYTES + tweets[i].length();
+    }
+    out.reserve(out.size() + LENGTH_BYTES + bodyBytes);
+    appendUint32(out, (uint32_t)bodyBytes);
+    appendUint32(out, (uint32_t)count);
+    for (size_t i = 0; i < count; i++) {
+        appendUint32(out, (uint32_t)tweets[i].length());
+        out.insert(out.end(), tweets[i].data(), tweets[i].data() + tweets[i].length());
+    }
+}
+
+// Walk the tweets of a request body, checking every length against what is left.
+bool ScoringProtocol::parseRequest(const char* body, size_t bodyBytes, std::vector<DSStringView>& tweets) {
+    tweets.clear();
+    if (bodyBytes < LENGTH_BYTES) {
+        return false;
+    }
+    uint32_t count = readUint32(body);
+    size_t offset = LENGTH_BYTES;
+    if (count > (bodyBytes - offset) / LENGTH_BYTES) {
+        return false;             // Not even room for the length fields
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (bodyBytes - offset < LENGTH_BYTES) {
+            return false;
+        }
+        uint32_t length = readUint32(body + offset);
+        offset += LENGTH_BYTES;
+        if (bodyBytes - offset < length) {
+            return false;
+        }
+        tweets.push_back(DSStringView(body + offset, length));
+        offset += length;
+    }
+    return offset == bodyBytes;   // No trailing bytes
+}
+
+// Length and count; the sentiment bytes follow.
+size_t ScoringProtocol::appendResponseHeader(std::vector<char>& out, size_t count) {
+    appendUint32(out, (uint32_t)(LENGTH_BYTES + count));
+    appendUint32(out, (uint32_t)count);
+    size_t sentiments = out.size();
+    out.resize(sentiments + count);
+    return sentiments;
+}
+
+// A response body is its count followed by exactly that many bytes.
+bool ScoringProtocol::parseResponse(const char* body, size_t bodyBytes, size_t& count, const char*& sentiments) {
+    if (bodyBytes < LENGTH_BYTES) {
+        return false;
+    }
+    count = readUint32(body);
+    sentiments = body + LENGTH_BYTES;
+    return count == bodyBytes - LENGTH_BYTES;
+}
@@ -0,0 +1,47 @@
+#ifndef SCORINGPROTOCOL_H
+#define SCORINGPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DSStringView.h"
+
+// Frames exchanged with the scoring daemon (ScoringServer) over a Unix domain socket.
+// Every frame is a 32-bit length followed by that many bytes of body:
+//   request   [length][count] then count times [tweet length][tweet bytes]
+//   response  [length][count] then count sentiment bytes (0 or 4), in request order
+// A request carries one tweet or a batch. All integers are uint32_t in native byte order
+// (the socket is local, so both ends run on the same machine). A client may send any
+// number of requests before reading the responses; they are answered in order.
+class ScoringProtocol {
+public:
+    static const size_t LENGTH_BYTES = 4;
+    static const uint32_t MAX_BODY_BYTES = 16u << 20;  // larger frames are rejected
+
+    enum FrameStatus {
+        FRAME_COMPLETE,    // a whole frame is available
+        FRAME_INCOMPLETE,  // more bytes are needed
+        FRAME_INVALID      // the length is over MAX_BODY_BYTES
+    };
+
+    // Looks at the start of data[0 .. size): on FRAME_COMPLETE, 'frameBytes' is the
+    // size of the first frame (length field included).
+    static FrameStatus nextFrame(const char* data, size_t size, size_t& frameBytes);
+
+    // Appends a request frame for tweets[0 .. count).
+    static void appendRequest(std::vector<char>& out, const DSStringView* tweets, size_t count);
+
+    // Splits a request body (the bytes after the length field) into views of its tweets.
+    // Returns false if the body is malformed.
+    static bool parseRequest(const char* body, size_t bodyBytes, std::vector<DSStringView>& tweets);
+
+    // Appends the header of a response frame for 'count' sentiments and returns where
+    // the sentiment bytes go; the caller fills out[result .. result + count).
+    static size_t appendResponseHeader(std::vector<char>& out, size_t count);
+
+    // Reads a response body: its sentiment count and a pointer to the sentiment bytes.
+    // Returns false if the body is malformed.
+    static bool parseResponse(const char* body, size_t bodyBytes, size_t& count, const char*& sentiments);
+};
+
+#endif // SCORINGPROTOCOL_H
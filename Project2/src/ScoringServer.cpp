@@ -0,0 +1,350 @@
+#include "ScoringServer.h"     // Include the header file for the ScoringServer class
+#include "ScoringProtocol.h"      // Include the frame format of requests and replies
+#include <cerrno>                 // Include cerrno to tell "try again later" from real errors
+#include <cstring>                // Include cstring for memmove(), strncpy() and strerror()
+#include <iostream>               // Include iostream for error messages (std::cerr)
+#include <fcntl.h>                // Include fcntl.h for fcntl() to make sockets non-blocking
+#include <sys/epoll.h>            // Include sys/epoll.h for the event loop
+#include <sys/socket.h>           // Include sys/socket.h for socket(), bind(), accept() and send()
+#include <sys/stat.h>             // Include sys/stat.h for lstat() to check what is at the socket path
+#include <sys/un.h>               // Include sys/un.h for Unix domain socket addresses
+#include <unistd.h>               // Include unistd.h for read(), write(), close() and unlink()
+
+// Bytes read from a socket per read() call (the input buffer keeps at least this much free).
+static const size_t READ_CHUNK = 64 * 1024;
+// Replies a connection may have waiting before the server stops reading its requests.
+static const size_t MAX_PENDING_OUTPUT = 4 << 20;
+// Events handled per epoll_wait() call.
+static const int MAX_EVENTS = 64;
+
+// One client: its socket, the bytes received but not yet answered, and the replies not
+// yet sent. Both buffers keep their capacity, so a steady client causes no allocations.
+struct ScoringConnection {
+    int fd;
+    size_t index;                 // position in ScoringServer::connections
+    std::vector<char> input;      // input[inputBegin .. inputEnd) is unprocessed
+    size_t inputBegin;
+    size_t inputEnd;
+    std::vector<char> output;     // output[outputBegin ..) is unsent
+    size_t outputBegin;
+    uint32_t interest;            // the epoll events registered for fd
+    bool peerClosed;              // the client will send nothing more
+
+    explicit ScoringConnection(int fd)
+        : fd(fd), index(0), input(READ_CHUNK), inputBegin(0), inputEnd(0), outputBegin(0), interest(0),
+          peerClosed(false) {}
+};
+
+// Put a descriptor into non-blocking mode.
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Make room for the socket at 'address': nothing may be there, or only a stale socket
+// file, one that no server accepts connections on any more, which is removed. Anything
+// else (a regular file, a directory, a live server's socket) is left alone and reported.
+static bool clearSocketPath(const struct sockaddr_un& address) {
+    const char* path = address.sun_path;
+    struct stat st;
+    if (lstat(path, &st) != 0) {
+        if (errno == ENOENT) {
+            return true;          // Nothing there
+        }
+        std::cerr << "Error: Unable to check socket path " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        std::cerr << "Error: " << path << " exists and is not a socket." << std::endl;
+        return false;
+    }
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe < 0) {
+        std::cerr << "Error: Unable to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    int connectError = (connect(probe, (const struct sockaddr*)&address, sizeof(address)) == 0) ? 0 : errno;
+    close(probe);
+    if (connectError == 0) {
+        std::cerr << "Error: Another server is already listening on " << path << "." << std::endl;
+        return false;
+    }
+    if (connectError != ECONNREFUSED && connectError != ENOENT) {
+        std::cerr << "Error: Unable to check socket " << path << ": " << strerror(connectError) << std::endl;
+        return false;             // Refused means no one is listening; anything else is not proof of that
+    }
+    if (unlink(path) != 0 && errno != ENOENT) {
+        std::cerr << "Error: Unable to remove stale socket " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Constructor: nothing is open until listen().
+ScoringServer::ScoringServer(const SentimentClassifier& classifier)
+    : classifier(classifier), listenFd(-1), epollFd(-1), requests(0), tweetsScored(0) {
+    wakeFds[0] = -1;
+    wakeFds[1] = -1;
+}
+
+// Destructor: close everything that is still open.
+ScoringServer::~ScoringServer() {
+    shutdown();
+}
+
+// Bind the socket, and set up the event loop with the listening socket and the wake pipe.
+bool ScoringServer::listen(const char* path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long: " << path << std::endl;
+        return false;
+    }
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    if (!clearSocketPath(address)) {
+        return false;             // A socket file left behind by an earlier run would make bind() fail
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: Unable to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (bind(listenFd, (struct sockaddr*)&address, sizeof(address)) != 0 || ::listen(listenFd, SOMAXCONN) != 0 ||
+        !setNonBlocking(listenFd)) {
+        std::cerr << "Error: Unable to listen on " << path << ": " << strerror(errno) << std::endl;
+        shutdown();
+        return false;
+    }
+    socketPath = path;
+
+    epollFd = epoll_create1(0);
+    if (epollFd < 0 || pipe(wakeFds) != 0) {
+        std::cerr << "Error: Unable to set up the event loop: " << strerror(errno) << std::endl;
+        shutdown();
+        return false;
+    }
+    // The listening socket and the wake pipe are told apart from clients by their data pointers.
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.ptr = &wakeFds[0];
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFds[0], &event);
+    return true;
+}
+
+// Wake the event loop; write() is async-signal-safe, so this works from a signal handler.
+void ScoringServer::stop() {
+    if (wakeFds[1] >= 0) {
+        char byte = 0;
+        ssize_t ignored = write(wakeFds[1], &byte, 1);
+        (void)ignored;            // A full pipe already holds a wake-up
+    }
+}
+
+// The event loop.
+bool ScoringServer::run() {
+    if (epollFd < 0) {
+        return false;
+    }
+    struct epoll_event events[MAX_EVENTS];
+    bool ok = true;
+    bool stopping = false;
+    while (!stopping) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;         // A signal (e.g. the one that calls stop()) interrupted the wait
+            }
+            std::cerr << "Error: Event loop failed: " << strerror(errno) << std::endl;
+            ok = false;
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            void* source = events[i].data.ptr;
+            if (source == &wakeFds[0]) {
+                stopping = true;
+            } else if (source == &listenFd) {
+                acceptClients();
+            } else {
+                ScoringConnection* connection = (ScoringConnection*)source;
+                // Replies first, so a connection blocked on output can read again.
+                if (events[i].events & EPOLLOUT) {
+                    writeReplies(connection);
+                }
+                if (connection->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                    readRequests(connection);
+                }
+                if (connection->fd < 0) {
+                    delete connection;    // Closed while handling this event
+                }
+            }
+        }
+    }
+    shutdown();
+    return ok;
+}
+
+// Accept every pending client and watch it for requests.
+void ScoringServer::acceptClients() {
+    for (;;) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            return;               // EAGAIN: no more pending clients (other errors: try on the next event)
+        }
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        ScoringConnection* connection = new ScoringConnection(fd);
+        connection->index = connections.size();
+        connections.push_back(connection);
+        connection->interest = EPOLLIN;
+        struct epoll_event event;
+        event.events = connection->interest;
+        event.data.ptr = connection;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+// Close a client's socket and forget it. The object itself is deleted by run() once the
+// event that led here has been handled.
+void ScoringServer::closeConnection(ScoringConnection* connection) {
+    close(connection->fd);        // Also removes it from the epoll set
+    connection->fd = -1;
+    ScoringConnection* last = connections.back();
+    connections[connection->index] = last;
+    last->index = connection->index;
+    connections.pop_back();
+}
+
+// Read what the client sent and answer every complete request in it.
+void ScoringServer::readRequests(ScoringConnection* connection) {
+    // Make room for a full read: drop processed bytes, then grow if still short.
+    if (connection->input.size() - connection->inputEnd < READ_CHUNK) {
+        size_t pending = connection->inputEnd - connection->inputBegin;
+        memmove(connection->input.data(), connection->input.data() + connection->inputBegin, pending);
+        connection->inputBegin = 0;
+        connection->inputEnd = pending;
+        if (connection->input.size() - pending < READ_CHUNK) {
+            connection->input.resize(pending + READ_CHUNK);
+        }
+    }
+    ssize_t received = read(connection->fd, connection->input.data() + connection->inputEnd,
+                            connection->input.size() - connection->inputEnd);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+    if (received <= 0) {
+        connection->peerClosed = true;   // End of input (or an error): answer what is here, then close
+    } else {
+        connection->inputEnd += (size_t)received;
+    }
+
+    // Answer the complete frames, in order, into the output buffer.
+    size_t frameBytes = 0;
+    for (;;) {
+        const char* frame = connection->input.data() + connection->inputBegin;
+        ScoringProtocol::FrameStatus status =
+            ScoringProtocol::nextFrame(frame, connection->inputEnd - connection->inputBegin, frameBytes);
+        if (status == ScoringProtocol::FRAME_INCOMPLETE) {
+            break;
+        }
+        if (status == ScoringProtocol::FRAME_INVALID ||
+            !ScoringProtocol::parseRequest(frame + ScoringProtocol::LENGTH_BYTES,
+                                           frameBytes - ScoringProtocol::LENGTH_BYTES, tweets)) {
+            closeConnection(connection);
+            return;
+        }
+        size_t sentiments = ScoringProtocol::appendResponseHeader(connection->output, tweets.size());
+        for (size_t i = 0; i < tweets.size(); i++) {
+            connection->output[sentiments + i] = (char)classifier.predict(tweets[i]);
+        }
+        connection->inputBegin += frameBytes;
+        requests++;
+        tweetsScored += tweets.size();
+    }
+    if (connection->inputBegin == connection->inputEnd) {
+        connection->inputBegin = 0;      // Everything answered: reuse the buffer from the start
+        connection->inputEnd = 0;
+    }
+    writeReplies(connection);
+}
+
+// Send as much of the pending replies as the socket takes.
+void ScoringServer::writeReplies(ScoringConnection* connection) {
+    while (connection->outputBegin < connection->output.size()) {
+        ssize_t sent = send(connection->fd, connection->output.data() + connection->outputBegin,
+                            connection->output.size() - connection->outputBegin, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;            // Socket buffer full: wait for EPOLLOUT
+            }
+            closeConnection(connection);  // The client went away
+            return;
+        }
+        connection->outputBegin += (size_t)sent;
+    }
+    if (connection->outputBegin == connection->output.size()) {
+        connection->output.clear();      // Keeps the capacity
+        connection->outputBegin = 0;
+        if (connection->peerClosed) {
+            closeConnection(connection);
+            return;
+        }
+    }
+    updateInterest(connection);
+}
+
+// Register the events the connection needs now: writability while replies are pending,
+// and readability unless too many replies are waiting or the client is done sending.
+void ScoringServer::updateInterest(ScoringConnection* connection) {
+    size_t pending = connection->output.size() - connection->outputBegin;
+    uint32_t interest = 0;
+    if (!connection->peerClosed && pending < MAX_PENDING_OUTPUT) {
+        interest |= EPOLLIN;
+    }
+    if (pending > 0) {
+        interest |= EPOLLOUT;
+    }
+    if (interest != connection->interest) {
+        struct epoll_event event;
+        event.events = interest;
+        event.data.ptr = connection;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->interest = interest;
+    }
+}
+
+// Close every client, the event loop and the listening socket, and remove the socket file.
+void ScoringServer::shutdown() {
+    while (!connections.empty()) {
+        ScoringConnection* connection = connections.back();
+        closeConnection(connection);
+        delete connection;
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+        socketPath.clear();
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (wakeFds[i] >= 0) {
+            close(wakeFds[i]);
+            wakeFds[i] = -1;
+        }
+    }
+}
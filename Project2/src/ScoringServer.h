@@ -0,0 +1,63 @@
+#ifndef SCORINGSERVER_H
+#define SCORINGSERVER_H
+
+#include <string>
+#include <vector>
+#include "DSStringView.h"
+#include "SentimentClassifier.h"
+
+struct ScoringConnection;
+
+// Resident scoring daemon: answers ScoringProtocol requests on a Unix domain socket
+// with a loaded classifier, so a model is loaded once and each tweet costs only its
+// predict call. One thread runs an epoll event loop over all client connections with
+// non-blocking sockets. Every complete request in a connection's input is answered in
+// order, so clients can pipeline. Replies are written straight away, or when the socket
+// is writable again if its buffer is full. A connection whose replies pile up (the
+// client is not reading) is not read until they drain. A malformed frame closes its
+// connection.
+class ScoringServer {
+private:
+    const SentimentClassifier& classifier;
+    std::string socketPath;
+    int listenFd;
+    int epollFd;
+    int wakeFds[2];               // stop() writes to wakeFds[1] to end run()
+    std::vector<ScoringConnection*> connections;
+    std::vector<DSStringView> tweets;   // the tweets of the request being answered
+    unsigned long long requests;
+    unsigned long long tweetsScored;
+
+    void acceptClients();
+    void closeConnection(ScoringConnection* connection);
+    void readRequests(ScoringConnection* connection);
+    void writeReplies(ScoringConnection* connection);
+    void updateInterest(ScoringConnection* connection);
+    void shutdown();
+
+    // Not copyable.
+    ScoringServer(const ScoringServer&);
+    ScoringServer& operator=(const ScoringServer&);
+public:
+    // The classifier must stay alive, and must not be retrained, while the server runs.
+    explicit ScoringServer(const SentimentClassifier& classifier);
+    ~ScoringServer();
+
+    // Creates the socket at 'path' and starts listening. A socket file no server accepts
+    // connections on is replaced; anything else already at 'path' is left alone.
+    // Returns false, after printing an error, if that fails.
+    bool listen(const char* path);
+
+    // Serves clients until stop() is called, then closes every connection and removes
+    // the socket file. Returns false on an event loop error.
+    bool run();
+
+    // Makes run() return. Safe to call from another thread or a signal handler.
+    void stop();
+
+    // Requests answered and tweets scored so far.
+    unsigned long long requestCount() const { return requests; }
+    unsigned long long tweetCount() const { return tweetsScored; }
+};
+
+#endif // SCORINGSERVER_H
@@ -1,237 +1,1206 @@
 #include "SentimentClassifier.h"       // Include the header file for the SentimentClassifier class
 #include "FileIO.h"                    // Include the header file for file I/O functions
-#include "Tokenizer.h"                 // Include the header file for tokenizing DSString objects
-#include "TextProcessor.h"             // Include the header file for text processing functions (toLower, remove punctuation, stop words, stemming)
+#include "MappedFile.h"                // Include the header file for zero-copy memory-mapped file access
+#include "ThreadPool.h"                // Include the header file for the worker pool used by evaluate
+#include "ModelFormat.h"               // Include the header file describing the binary model layout
+#include "CsvRecord.h"                 // Include the header file for the quote-aware CSV field parser
+#include "TextNormalizer.h"            // Include the header file for the single-pass tweet normalizer
+#include "Arena.h"                     // Include the header file for the arena holding evaluate's error lines
+#include "GroundTruth.h"               // Include the header file for the tweet-ID joins of evaluate
+#include "AsyncFileWriter.h"           // Include the header file for the background-thread output of evaluate
+#include "ReadCopyUpdate.h"            // Include the header file for the reader guards of update's snapshot swap
 #include <fstream>                     // Include fstream for file reading and writing
 #include <sstream>                     // Include sstream for string stream operations (if needed)
 #include <iostream>                    // Include iostream for console I/O (e.g., std::cout, std::cerr)
-#include <iomanip>                     // Include iomanip for output formatting (e.g., std::setprecision)
 #include <cmath>                       // Include cmath for mathematical functions (e.g., log)
-#include <set>                         // Include set for storing unique tokens
+#include <cstdint>                     // Include cstdint for the fixed-width integers of the model file
+#include <chrono>                      // Include chrono for timing training throughput
+#include <thread>                      // Include thread for parallel training workers
+#include <cstdio>                      // Include cstdio for snprintf() when formatting the accuracy
+#include <cstring>                     // Include cstring for memchr(), memcpy() and memcmp()
+#include <sys/stat.h>                  // Include sys/stat.h for lstat() before removing a partial output file
+#include <unistd.h>                    // Include unistd.h for unlink()
+#include <algorithm>                   // Include algorithm for sorting the terms an update changed
+#include <utility>                     // Include utility for std::move when retiring grown key arrays
+
+// Constructor: start with empty maps and zero tweet counts.
+WordCounts::WordCounts() : positiveTweetCount(0), negativeTweetCount(0) {
+}
+
+// Look up (or add) a term and keep one TermStats record per term ID.
+TermId WordCounts::internTerm(const DSStringView& term) {
+    TermId id = terms.intern(term);
+    if (id == stats.size()) {
+        stats.push_back(TermStats());  // A new term gets the next ID, i.e. the next record
+    }
+    return id;
+}
+
+// Add every word frequency and tweet count of 'other' to this object.
+// Counts are plain integer sums, so the merge order does not affect the result.
+void WordCounts::merge(const WordCounts& other) {
+    positiveTweetCount += other.positiveTweetCount;
+    negativeTweetCount += other.negativeTweetCount;
+    for (size_t i = 0; i < other.terms.size(); i++) {
+        const TermStats& source = other.stats[i];
+        TermStats& stats = this->stats[internTerm(other.terms.keyAt(i))];
+        stats.positive += source.positive;
+        stats.negative += source.negative;
+        stats.documents += source.documents;  // Shards hold disjoint tweets, so this is exact.
+    }
+}
+
+// A model version no classifier has used yet.
+static uint64_t nextModelVersion() {
+    static std::atomic<uint64_t> counter(0);
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// Constructor: an untrained model scores every tweet 0.
+ScoringModel::ScoringModel()
+    : termStats(nullptr), termLogRatios(nullptr), tokenLogRatio(0.0), logPriorRatio(0.0),
+      positiveTweetCount(0), negativeTweetCount(0), totalPositiveWords(0), totalNegativeWords(0),
+      vocabularySize(0), version(nextModelVersion()) {
+}
+
+// One thread's token cache counters for one classifier. Only the owning thread writes
+// them (plain loads and stores, no read-modify-write); the padding keeps other blocks
+// and other allocations off their cache line.
+struct SentimentClassifier::CacheCounters {
+    char padding[64];
+    std::atomic<unsigned long long> hits;
+    std::atomic<unsigned long long> misses;
+    std::atomic<unsigned long long> uncached;
+    std::thread::id owner;
+
+    explicit CacheCounters(std::thread::id owner) : hits(0), misses(0), uncached(0), owner(owner) {}
+
+    void add(const TokenCacheStats& stats) {
+        hits.store(hits.load(std::memory_order_relaxed) + stats.hits, std::memory_order_relaxed);
+        misses.store(misses.load(std::memory_order_relaxed) + stats.misses, std::memory_order_relaxed);
+        uncached.store(uncached.load(std::memory_order_relaxed) + stats.uncached, std::memory_order_relaxed);
+    }
+};
+
+// Keys of the terms of an updated model, shared by both copies of its tables (see
+// ModelSnapshot). Keys are only ever appended, and a reader only looks at the keys of
+// the terms its model has, so appending never writes anything a reader can see. An
+// array that has to grow is copied into a bigger one, and the old one is kept until
+// freeRetired(), which update() calls once no reader can still use it.
+struct SharedTermKeys {
+    std::vector<uint32_t> offsets;     // size() + 1 offsets into 'pool'
+    std::vector<char> pool;
+    std::vector<std::vector<uint32_t> > retiredOffsets;
+    std::vector<std::vector<char> > retiredPools;
+
+    SharedTermKeys() : offsets(1, 0) {}
+
+    void append(const DSStringView& key);
+    void freeRetired();
+};
+
+// One copy of an updated model's tables, with the scoring model pointing into them.
+// update() keeps two: readers use the one published last, and the next update counts
+// into the other one once it has copied over the changes of the published one. Each
+// has its own probe table over the shared keys, grown exactly like a StringInterner's,
+// so the saved file is the one a training run on the same tweets writes.
+struct SentimentClassifier::ModelSnapshot {
+    SharedTermKeys* keys;
+    std::vector<StringHashSlot> slots;
+    std::vector<TermStats> stats;      // one record per term this copy has
+    std::vector<double> logRatios;     // per-term part of each log ratio (see ScoringModel)
+    int positiveTweetCount;
+    int negativeTweetCount;
+    int totalPositiveWords;            // the word totals, added to tweet by tweet
+    int totalNegativeWords;
+    ScoringModel model;
+
+    explicit ModelSnapshot(SharedTermKeys* keys)
+        : keys(keys), positiveTweetCount(0), negativeTweetCount(0), totalPositiveWords(0), totalNegativeWords(0) {}
+
+    StringHashIndex index() const;
+    TermId internTerm(const DSStringView& term);
+    void addKey(TermId id);
+    void copyChanges(const ModelSnapshot& other, const std::vector<TermId>& changed);
+    void freezeModel();
+};
+
+// update()'s two copies of the model tables, and the keys they share.
+struct SentimentClassifier::UpdateState {
+    SharedTermKeys keys;
+    std::unique_ptr<ModelSnapshot> copies[2];  // the second one is made by the second update
+    size_t live;                  // the copy readers may be using (null before the first publish)
+    std::vector<TermId> changed;  // terms the last update changed (sorted), still to copy to the other one
+
+    UpdateState() : live(1) {}
+};
 
 // Constructor: Initialize all counters and variables to 0.
 SentimentClassifier::SentimentClassifier() 
-    : positiveTweetCount(0), negativeTweetCount(0),
-      totalPositiveWords(0), totalNegativeWords(0), vocabularySize(0) {
+    : totalPositiveWords(0), totalNegativeWords(0), vocabularySize(0),
+      published(&model), cacheCapacity(0),
+      cacheHits(0), cacheMisses(0), cacheUncached(0), instanceId(nextModelVersion()),
+      progressRecords(0), progressBytes(0), progressStartNanos(0), progressEndNanos(0) {
     // Constructor body is empty since initialization is done in the initializer list.
 }
 
+// Destructor: frees the tables of update(), if any.
+SentimentClassifier::~SentimentClassifier() {
+}
+
+// Current time on a monotonic clock, in nanoseconds.
+static long long nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Throughput helpers for a progress snapshot.
+double TrainingProgress::recordsPerSecond() const {
+    return (seconds > 0.0) ? records / seconds : 0.0;
+}
+
+double TrainingProgress::megabytesPerSecond() const {
+    return (seconds > 0.0) ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+// Reset the progress counters at the start of a training run.
+void SentimentClassifier::beginProgress() {
+    progressRecords.store(0, std::memory_order_relaxed);
+    progressBytes.store(0, std::memory_order_relaxed);
+    progressEndNanos.store(0, std::memory_order_relaxed);
+    progressStartNanos.store(nowNanos(), std::memory_order_release);
+}
+
+// Count one processed record (lineBytes includes its newline).
+void SentimentClassifier::recordProgress(size_t lineBytes) {
+    progressRecords.fetch_add(1, std::memory_order_relaxed);
+    progressBytes.fetch_add(lineBytes, std::memory_order_relaxed);
+}
+
+// Stop the clock at the end of a training run.
+void SentimentClassifier::endProgress() {
+    progressEndNanos.store(nowNanos(), std::memory_order_release);
+}
+
+// Snapshot of the progress counters; may be called from any thread.
+TrainingProgress SentimentClassifier::trainingProgress() const {
+    TrainingProgress progress;
+    long long start = progressStartNanos.load(std::memory_order_acquire);
+    long long end = progressEndNanos.load(std::memory_order_acquire);
+    progress.records = progressRecords.load(std::memory_order_relaxed);
+    progress.bytes = progressBytes.load(std::memory_order_relaxed);
+    progress.running = (start != 0 && end == 0);
+    if (start == 0) {
+        progress.seconds = 0.0;   // Training has never started.
+    } else {
+        progress.seconds = ((progress.running ? nowNanos() : end) - start) / 1e9;
+    }
+    return progress;
+}
+
 // Helper function: Preprocess and tokenize a tweet.
-// This function takes a DSString containing tweet text, cleans it, tokenizes it, removes stop words, and stems each token.
-std::vector<DSString> SentimentClassifier::tokenizeTweet(const DSString& tweetText) {
-    // Convert the tweet text to lowercase and remove punctuation.
-    DSString cleaned = TextProcessor::removePunctuation(TextProcessor::toLower(tweetText));
-    // Tokenize the cleaned text into tokens based on spaces.
-    std::vector<DSString> tokens = Tokenizer::tokenize(cleaned, ' ');
-    // Remove common stop words from the tokens.
-    tokens = TextProcessor::removeStopWords(tokens);
-    // Create a vector to hold the stemmed tokens.
-    std::vector<DSString> stemmedTokens;
-    // For each token in the vector...
-    for (size_t i = 0; i < tokens.size(); i++) {
-        // Apply stemming to the token and add the result to the stemmedTokens vector.
-        stemmedTokens.push_back(TextProcessor::stem(tokens[i]));
-    }
-    // Return the final vector of processed tokens.
-    return stemmedTokens;
+// Lowercasing, punctuation removal, splitting on spaces, stop-word removal and stemming
+// all happen in one pass of a TextNormalizer. Each thread has its own normalizer so
+// concurrent predict calls never share scratch space, and its buffers are reused from
+// tweet to tweet. The returned views are valid until the thread's next call.
+static thread_local TextNormalizer normalizer;
+
+static const std::vector<DSStringView>& tokenizeTweet(const DSStringView& tweetText) {
+    return normalizer.normalize(tweetText);
+}
+
+// Stands for a word that normalizes to nothing (empty or a stop word) in a TokenCache.
+static const uint32_t DROPPED_WORD = 0xFFFFFFFEu;
+
+// Map the tokens of a tweet to term IDs with 'resolve' (normalized token -> TermId),
+// going through 'cache' word by word. Normalization never lets a word cross a ' ', so
+// the tokens of a tweet are the tokens of its space-separated words in order, and each
+// word normalizes to one token or none. Only words the cache does not know are
+// normalized (on their own) and resolved. A disabled cache normalizes the whole tweet.
+template <typename Resolve>
+static void encodeWords(const DSStringView& tweetText, TokenCache& cache, std::vector<TermId>& termIds, Resolve resolve) {
+    termIds.clear();
+    if (cache.capacity() == 0) {
+        const std::vector<DSStringView>& words = tokenizeTweet(tweetText);
+        for (size_t i = 0; i < words.size(); i++) {
+            termIds.push_back(resolve(words[i]));
+        }
+        return;
+    }
+    const char* word = tweetText.data();
+    const char* end = word + tweetText.length();
+    while (true) {
+        const char* space = (const char*)memchr(word, ' ', end - word);
+        DSStringView raw(word, ((space != nullptr) ? space : end) - word);
+        if (raw.length() > 0) {   // Consecutive spaces make empty words, which are dropped
+            uint32_t id;
+            if (!cache.lookup(raw, id)) {
+                DSStringView token;
+                id = normalizer.normalizeWord(raw, token) ? resolve(token) : DROPPED_WORD;
+                cache.insert(raw, id);
+            }
+            if (id != DROPPED_WORD) {
+                termIds.push_back(id);
+            }
+        }
+        if (space == nullptr) {
+            break;
+        }
+        word = space + 1;
+    }
 }
 
 // Process a single training tweet.
 // The expected CSV format is: sentiment, tweetID, date, query, username, tweet_text.
-void SentimentClassifier::processTrainingTweet(const DSString& tweetLine) {
-    // Tokenize the CSV line using a comma as the delimiter.
-    std::vector<DSString> tokens = Tokenizer::tokenize(tweetLine, ',');
-    // If there are fewer than 6 tokens, the line is invalid; skip processing.
-    if (tokens.size() < 6) {
-        return;  // Not enough tokens; skip this line.
+template <typename Counts>
+void SentimentClassifier::processTrainingTweet(const DSStringView& tweetLine, TrainingScratch& scratch, Counts& target) {
+    CsvRecord& fields = scratch.fields;
+    // Parse the CSV line into field offsets (no copies); a quoted tweet may contain commas.
+    fields.parse(tweetLine);
+    // If there are fewer than 6 fields, the line is invalid; skip processing.
+    if (fields.size() < 6) {
+        return;  // Not enough fields; skip this line.
     }
     
-    // Determine sentiment: if the first token is "4", treat the tweet as positive; otherwise, treat it as negative.
-    int sentiment = (tokens[0] == DSString("4")) ? 4 : 0;
-    // Extract the tweet text from the sixth token.
-    DSString tweetText = tokens[5];
-    
-    // Tokenize the tweet text using the helper function.
-    std::vector<DSString> words = tokenizeTweet(tweetText);
+    // Determine sentiment: if the first field is "4", treat the tweet as positive; otherwise, treat it as negative.
+    int sentiment = (fields[0] == "4") ? 4 : 0;
+    // Tokenize the tweet text (sixth field) straight from the line and intern the tokens;
+    // from here on the tweet is a vector of term IDs. Doubled quotes need not be
+    // collapsed first: the normalizer drops quotes anyway.
+    std::vector<TermId>& termIds = scratch.termIds;
+    encodeWords(fields[5], scratch.cache, termIds,
+                [&target](const DSStringView& term) { return target.internTerm(term); });
     
-    // If the tweet is positive, update the positive tweet count and word frequencies.
+    // Update the tweet count for the tweet's class; the running total doubles as this tweet's ID.
     if (sentiment == 4) {
-        positiveTweetCount++;  // Increment positive tweet counter.
-        for (size_t i = 0; i < words.size(); i++) {
-            positiveWords[words[i]]++;  // Increment frequency for each token in positive tweets.
-        }
+        target.positiveTweetCount++;  // Increment positive tweet counter.
     } else { // Otherwise, the tweet is negative.
-        negativeTweetCount++;  // Increment negative tweet counter.
-        for (size_t i = 0; i < words.size(); i++) {
-            negativeWords[words[i]]++;  // Increment frequency for each token in negative tweets.
+        target.negativeTweetCount++;  // Increment negative tweet counter.
+    }
+    int document = target.positiveTweetCount + target.negativeTweetCount;
+    
+    // Update the term entry of each token: its class count, and its document frequency
+    // the first time it appears in this tweet. Which tweet last counted a term is only
+    // needed while counting, so it is kept in the scratch space, not in the model.
+    std::vector<int>& lastDocument = scratch.lastDocument;
+    if (lastDocument.size() < target.stats.size()) {
+        lastDocument.resize(target.stats.size(), -1);
+    }
+    for (size_t i = 0; i < termIds.size(); i++) {
+        TermStats& stats = target.stats[termIds[i]];
+        if (sentiment == 4) {
+            stats.positive++;     // Increment frequency for each token in positive tweets.
+        } else {
+            stats.negative++;     // Increment frequency for each token in negative tweets.
+        }
+        if (lastDocument[termIds[i]] != document) {
+            lastDocument[termIds[i]] = document;
+            stats.documents++;
         }
     }
 }
 
 // Train the classifier using the training data file.
-void SentimentClassifier::train(const char* trainingFile) {
-    // Read all lines from the training file into a vector of DSString objects.
-    std::vector<DSString> lines = FileIO::readLines(trainingFile);
+bool SentimentClassifier::train(const char* trainingFile) {
+    // Map the training file into memory; lines are handed out as views into the mapping,
+    // so the file is never copied and no per-line strings are allocated.
+    MappedFile file;
+    if (!file.open(trainingFile)) {
+        return false;                // open() has already reported the error
+    }
+    DSStringView contents = file.view();
+    TrainingScratch scratch(cacheCapacity);  // Reused for every line.
+    size_t offset = 0;
+    DSStringView line;
     // Process each line (i.e., each tweet) from the training data.
-    for (size_t i = 0; i < lines.size(); i++) {
-        processTrainingTweet(lines[i]);
+    beginProgress();
+    while (FileIO::nextLine(contents, offset, line)) {
+        processTrainingTweet(line, scratch, counts);
+        recordProgress(line.length() + 1);
     }
+    endProgress();
+    addCacheStats(scratch.cache.stats());
     
-    // Calculate the total number of words in positive tweets.
-    for (auto &entry : positiveWords) {
-        totalPositiveWords += entry.second;
+    computeTotals();
+    return true;
+}
+
+// Train the classifier by streaming the training file in fixed-size chunks.
+// Only one chunk (plus at most one partial line) is ever held in memory.
+bool SentimentClassifier::trainStreaming(const char* trainingFile, size_t chunkSize) {
+    ChunkedLineReader reader(chunkSize);
+    if (!reader.open(trainingFile)) {
+        return false;                // open() has already reported the error
     }
-    // Calculate the total number of words in negative tweets.
-    for (auto &entry : negativeWords) {
-        totalNegativeWords += entry.second;
+    TrainingScratch scratch(cacheCapacity);  // Reused for every line.
+    DSStringView line;
+    // Feed each record to the model as soon as it has been read.
+    beginProgress();
+    while (reader.nextLine(line)) {
+        processTrainingTweet(line, scratch, counts);
+        recordProgress(line.length() + 1);
     }
+    endProgress();
+    addCacheStats(scratch.cache.stats());
     
-    // Build the vocabulary as a set of unique words from both positive and negative tweets.
-    std::set<DSString> vocab;
-    // Insert each unique word from positive tweets.
-    for (auto &entry : positiveWords) {
-        vocab.insert(entry.first);
+    computeTotals();
+    return true;
+}
+
+// Count every line of 'lines' (a line-aligned slice of the training file) into 'target'.
+// Progress is published in batches so workers do not contend on the shared counters.
+void SentimentClassifier::processTrainingRange(const DSStringView& lines, WordCounts& target) {
+    const unsigned long long batchSize = 1024;  // Lines per progress update.
+    TrainingScratch scratch(cacheCapacity);  // Reused for every line; its cache maps into 'target'.
+    size_t offset = 0;
+    DSStringView line;
+    unsigned long long pendingRecords = 0;
+    unsigned long long pendingBytes = 0;
+    while (FileIO::nextLine(lines, offset, line)) {
+        processTrainingTweet(line, scratch, target);
+        pendingRecords++;
+        pendingBytes += line.length() + 1;
+        if (pendingRecords == batchSize) {
+            progressRecords.fetch_add(pendingRecords, std::memory_order_relaxed);
+            progressBytes.fetch_add(pendingBytes, std::memory_order_relaxed);
+            pendingRecords = 0;
+            pendingBytes = 0;
+        }
     }
-    // Insert each unique word from negative tweets.
-    for (auto &entry : negativeWords) {
-        vocab.insert(entry.first);
+    progressRecords.fetch_add(pendingRecords, std::memory_order_relaxed);
+    progressBytes.fetch_add(pendingBytes, std::memory_order_relaxed);
+    addCacheStats(scratch.cache.stats());
+}
+
+// Train the classifier on several threads.
+// The mapped file is cut into one byte range per worker, each cut moved forward to just
+// after the next newline so no line is split. Every worker fills its own WordCounts with
+// no locking, and the shards are merged into the model afterwards. Because the counts are
+// integer sums, the merged model is identical to the one train() builds.
+bool SentimentClassifier::trainParallel(const char* trainingFile, unsigned numThreads) {
+    MappedFile file;
+    if (!file.open(trainingFile)) {
+        return false;                // open() has already reported the error
     }
-    // Set the vocabulary size to the number of unique words.
-    vocabularySize = vocab.size();
+    DSStringView contents = file.view();
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();  // May be 0 if unknown.
+    }
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+
+    // Find the range boundaries: cut i starts right after the first newline at or past i*size/n.
+    size_t size = contents.length();
+    std::vector<size_t> cuts(numThreads + 1, size);
+    cuts[0] = 0;
+    for (unsigned i = 1; i < numThreads; i++) {
+        size_t cut = (size_t)((unsigned long long)size * i / numThreads);
+        if (cut < cuts[i - 1]) {
+            cut = cuts[i - 1];    // A very long line already covered this point.
+        }
+        const char* newline = (const char*)memchr(contents.data() + cut, '\n', size - cut);
+        cuts[i] = (newline != nullptr) ? (size_t)(newline - contents.data()) + 1 : size;
+    }
+
+    // Count each range on its own thread into its own shard (the caller's thread takes range 0).
+    std::vector<WordCounts> shards(numThreads);
+    std::vector<std::thread> workers;
+    beginProgress();
+    for (unsigned i = 1; i < numThreads; i++) {
+        DSStringView range = contents.substr(cuts[i], cuts[i + 1] - cuts[i]);
+        workers.push_back(std::thread(&SentimentClassifier::processTrainingRange, this, range, std::ref(shards[i])));
+    }
+    processTrainingRange(contents.substr(0, cuts[1]), shards[0]);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    endProgress();
+
+    // Merge the shards into the model's counts.
+    for (unsigned i = 0; i < numThreads; i++) {
+        counts.merge(shards[i]);
+    }
+    computeTotals();
+    return true;
 }
 
-// Predict sentiment using a Naive Bayes approach.
-// The function returns 4 for positive sentiment and 0 for negative sentiment.
-int SentimentClassifier::predict(const DSString& tweetText) {
-    // Tokenize and process the tweet text.
-    std::vector<DSString> words = tokenizeTweet(tweetText);
+// Compute the per-class word totals and the vocabulary size from the term table.
+void SentimentClassifier::computeTotals() {
+    totalPositiveWords = 0;
+    totalNegativeWords = 0;
+    // Calculate the total number of words in positive and in negative tweets.
+    for (size_t i = 0; i < counts.stats.size(); i++) {
+        totalPositiveWords += counts.stats[i].positive;
+        totalNegativeWords += counts.stats[i].negative;
+    }
+    // Every entry is a unique word seen in training, so the vocabulary size is the table size.
+    vocabularySize = counts.terms.size();
     
-    // Compute the total number of training tweets.
+    freeze();
+}
+
+// Laplace smoothing: every term count is increased by alpha = 1.0.
+static const double ALPHA = 1.0;
+
+// Per-term part of a term's log-likelihood ratio (see ScoringModel). It only depends on
+// the term's own counts, so it is computed once per term instead of once per token
+// occurrence, and an update only recomputes it for the terms it counted.
+static double termLogRatio(const TermStats& stats) {
+    return log(stats.positive + ALPHA) - log(stats.negative + ALPHA);
+}
+
+// Set everything in 'model' that depends on the totals alone: the per-token part of the
+// log ratios, the log prior ratio and the counts saved with the model. freeze() and
+// update() both go through here and termLogRatio(), so an updated model is bit-for-bit
+// the model trained on the same tweets.
+static void setModelTotals(ScoringModel& model, int positiveTweetCount, int negativeTweetCount,
+                           int totalPositiveWords, int totalNegativeWords, int vocabularySize) {
+    double positiveDenominator = totalPositiveWords + ALPHA * vocabularySize;
+    double negativeDenominator = totalNegativeWords + ALPHA * vocabularySize;
+    model.tokenLogRatio = log(negativeDenominator) - log(positiveDenominator);
+
+    // Log prior ratio from the class frequencies of the training tweets.
     int totalTweets = positiveTweetCount + negativeTweetCount;
-    // Calculate the log prior probability for the positive class.
-    double logPriorPositive = log((double)positiveTweetCount / totalTweets);
-    // Calculate the log prior probability for the negative class.
-    double logPriorNegative = log((double)negativeTweetCount / totalTweets);
-    
-    // Initialize the log probabilities with the log prior probabilities.
-    double logProbPositive = logPriorPositive;
-    double logProbNegative = logPriorNegative;
-    
-    // For each token in the processed tweet...
-    for (size_t i = 0; i < words.size(); i++) {
-        DSString word = words[i];  // Get the current token.
-        // Retrieve the frequency of the token in positive tweets.
-        int countPositive = positiveWords[word];
-        // Retrieve the frequency of the token in negative tweets.
-        int countNegative = negativeWords[word];
-        
-        double alpha = 1.0; // Use Laplace smoothing with alpha = 1.0.
-        // Compute the smoothed probability of the token in the positive class.
-        double wordProbPositive = (countPositive + alpha) / (totalPositiveWords + alpha * vocabularySize);
-        // Compute the smoothed probability of the token in the negative class.
-        double wordProbNegative = (countNegative + alpha) / (totalNegativeWords + alpha * vocabularySize);
-        
-        // Update the log probability for the positive class by adding the log of the token's probability.
-        logProbPositive += log(wordProbPositive);
-        // Update the log probability for the negative class by adding the log of the token's probability.
-        logProbNegative += log(wordProbNegative);
+    model.logPriorRatio = log((double)positiveTweetCount / totalTweets)
+                        - log((double)negativeTweetCount / totalTweets);
+
+    model.positiveTweetCount = positiveTweetCount;
+    model.negativeTweetCount = negativeTweetCount;
+    model.totalPositiveWords = totalPositiveWords;
+    model.totalNegativeWords = totalNegativeWords;
+    model.vocabularySize = vocabularySize;
+    model.version = nextModelVersion();  // Cached term IDs of the previous model are stale
+}
+
+// Precompute everything predict needs so that scoring does no log() calls.
+void SentimentClassifier::freeze() {
+    // Per-term part of the log ratio for every known term.
+    logLikelihoodRatios.resize(counts.stats.size());
+    for (size_t i = 0; i < counts.stats.size(); i++) {
+        logLikelihoodRatios[i] = termLogRatio(counts.stats[i]);
     }
+    setModelTotals(model, counts.positiveTweetCount, counts.negativeTweetCount, totalPositiveWords,
+                   totalNegativeWords, vocabularySize);
+
+    // Point the scoring arrays at the tables.
+    model.termIndex = counts.terms.index();
+    model.termStats = counts.stats.data();
+    model.termLogRatios = logLikelihoodRatios.data();
+    // The trained tables replace any loaded or updated model (train never runs during predict).
+    modelFile.close();
+    published.store(&model);
+    updates.reset();
+}
+
+// Make room for 'extra' more elements at the end of 'array' without moving the ones a
+// reader may be using: a full array is copied into one twice as big, and the old one is
+// moved to 'retired'.
+template <typename T>
+static void reserveShared(std::vector<T>& array, size_t extra, std::vector<std::vector<T> >& retired) {
+    if (array.size() + extra <= array.capacity()) {
+        return;                   // Appending stays in place
+    }
+    std::vector<T> grown;
+    grown.reserve(std::max(2 * array.capacity(), array.size() + extra));
+    grown.assign(array.begin(), array.end());
+    grown.swap(array);
+    retired.push_back(std::move(grown));
+}
+
+// Append a key behind every existing one.
+void SharedTermKeys::append(const DSStringView& key) {
+    reserveShared(pool, key.length(), retiredPools);
+    pool.insert(pool.end(), key.data(), key.data() + key.length());
+    reserveShared(offsets, 1, retiredOffsets);
+    offsets.push_back((uint32_t)pool.size());
+}
+
+// Free the arrays replaced by growth (no reader may still be using them).
+void SharedTermKeys::freeRetired() {
+    retiredOffsets.clear();
+    retiredPools.clear();
+}
+
+// Lookup view of this copy's terms: its probe table over the shared keys.
+StringHashIndex SentimentClassifier::ModelSnapshot::index() const {
+    StringHashIndex view;
+    view.slots = slots.data();
+    view.slotCount = slots.size();
+    view.keyOffsets = keys->offsets.data();
+    view.keyPool = keys->pool.data();
+    view.size = stats.size();
+    return view;
+}
+
+// Look up (or add) a term, like WordCounts::internTerm: a new term's key is appended to
+// the shared keys, so this copy must have every term they hold.
+TermId SentimentClassifier::ModelSnapshot::internTerm(const DSStringView& term) {
+    if (StringInterner::needsGrowth(stats.size(), slots.size())) {
+        StringInterner::rehashSlots(slots, StringInterner::growCapacity(slots.size()));
+    }
+    uint32_t h = StringHashIndex::hash(term.data(), term.length());
+    size_t i = index().probe(term.data(), term.length(), h);
+    if (slots[i].index != StringHashIndex::EMPTY) {
+        return slots[i].index;    // Seen before: its existing ID
+    }
+    TermId id = (TermId)stats.size();
+    keys->append(term);
+    slots[i].hash = h;
+    slots[i].index = id;
+    stats.push_back(TermStats());
+    logRatios.push_back(0.0);     // Set once the update has counted all its tweets
+    return id;
+}
+
+// Add term 'id', the next one after this copy's terms, whose key the other copy has
+// already appended to the shared keys.
+void SentimentClassifier::ModelSnapshot::addKey(TermId id) {
+    if (StringInterner::needsGrowth(id, slots.size())) {
+        StringInterner::rehashSlots(slots, StringInterner::growCapacity(slots.size()));
+    }
+    DSStringView key(keys->pool.data() + keys->offsets[id], keys->offsets[id + 1] - keys->offsets[id]);
+    uint32_t h = StringHashIndex::hash(key.data(), key.length());
+    size_t i = index().probe(key.data(), key.length(), h);  // The key is not in the table yet
+    slots[i].hash = h;
+    slots[i].index = id;
+}
+
+// Bring this copy up to date with 'other', which differs from it only in the terms
+// 'changed' lists, among them every term added since this copy's last one. The new keys
+// go into the probe table in ID order, growing it where the other copy's grew, so both
+// tables end up slot for slot the same.
+void SentimentClassifier::ModelSnapshot::copyChanges(const ModelSnapshot& other, const std::vector<TermId>& changed) {
+    size_t known = stats.size();
+    stats.resize(other.stats.size());
+    logRatios.resize(other.logRatios.size());
+    for (size_t i = 0; i < changed.size(); i++) {
+        stats[changed[i]] = other.stats[changed[i]];
+        logRatios[changed[i]] = other.logRatios[changed[i]];
+    }
+    for (size_t id = known; id < stats.size(); id++) {
+        addKey((TermId)id);
+    }
+    while (slots.size() < other.slots.size()) {
+        // The other copy grew its table on a lookup after its last new term.
+        StringInterner::rehashSlots(slots, StringInterner::growCapacity(slots.size()));
+    }
+    positiveTweetCount = other.positiveTweetCount;
+    negativeTweetCount = other.negativeTweetCount;
+    totalPositiveWords = other.totalPositiveWords;
+    totalNegativeWords = other.totalNegativeWords;
+}
+
+// Point this copy's scoring model at its tables (whose log ratios must be up to date).
+void SentimentClassifier::ModelSnapshot::freezeModel() {
+    setModelTotals(model, positiveTweetCount, negativeTweetCount, totalPositiveWords, totalNegativeWords,
+                   (int)stats.size());
+    model.termIndex = index();
+    model.termStats = stats.data();
+    model.termLogRatios = logRatios.data();
+}
+
+// Copy the trained or loaded model into the first copy of update()'s tables: the keys
+// and the probe table as they are, so every term keeps its ID and its slot, and the
+// counts and log ratios. Readers keep using 'model' until the first update publishes.
+void SentimentClassifier::beginUpdates() {
+    std::unique_ptr<UpdateState> state(new UpdateState());
+    ModelSnapshot* first = new ModelSnapshot(&state->keys);
+    state->copies[0].reset(first);
+    const ScoringModel& current = model;
+    const StringHashIndex& index = current.termIndex;
+    if (index.keyOffsets != nullptr) {
+        state->keys.offsets.assign(index.keyOffsets, index.keyOffsets + index.size + 1);
+        state->keys.pool.assign(index.keyPool, index.keyPool + index.keyOffsets[index.size]);
+    }
+    first->slots.assign(index.slots, index.slots + index.slotCount);
+    first->stats.assign(current.termStats, current.termStats + index.size);
+    first->logRatios.assign(current.termLogRatios, current.termLogRatios + index.size);
+    first->positiveTweetCount = current.positiveTweetCount;
+    first->negativeTweetCount = current.negativeTweetCount;
+    first->totalPositiveWords = current.totalPositiveWords;
+    first->totalNegativeWords = current.totalNegativeWords;
+    updates.swap(state);
+}
+
+// Add new labeled tweets to the model and publish the result.
+void SentimentClassifier::update(const std::vector<DSStringView>& trainingLines) {
+    std::lock_guard<std::mutex> lock(updateMutex);
+    bool firstUpdate = (updates == nullptr);
+    if (firstUpdate) {
+        beginUpdates();
+    }
+    UpdateState& state = *updates;
+    std::unique_ptr<ModelSnapshot>& next = state.copies[1 - state.live];
+    if (next == nullptr) {
+        next.reset(new ModelSnapshot(*state.copies[state.live]));  // The second copy, made once
+    } else if (state.copies[state.live] != nullptr) {
+        next->copyChanges(*state.copies[state.live], state.changed);
+    }
+
+    // Count the tweets into the copy no reader uses, adding each tweet's tokens to the
+    // total of its class as it goes (the totals are the sums of the class counts), and
+    // note every term they touch.
+    std::vector<TermId>& changed = state.changed;
+    changed.clear();
+    TrainingScratch scratch(cacheCapacity);  // Reused for every line.
+    for (size_t i = 0; i < trainingLines.size(); i++) {
+        int positiveBefore = next->positiveTweetCount;
+        int negativeBefore = next->negativeTweetCount;
+        processTrainingTweet(trainingLines[i], scratch, *next);
+        if (next->positiveTweetCount != positiveBefore) {
+            next->totalPositiveWords += (int)scratch.termIds.size();
+        } else if (next->negativeTweetCount != negativeBefore) {
+            next->totalNegativeWords += (int)scratch.termIds.size();
+        } else {
+            continue;             // Not a training line: nothing was counted
+        }
+        changed.insert(changed.end(), scratch.termIds.begin(), scratch.termIds.end());
+    }
+    addCacheStats(scratch.cache.stats());
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    // Only the counted terms' own ratios changed; the totals only change the per-token one.
+    for (size_t i = 0; i < changed.size(); i++) {
+        next->logRatios[changed[i]] = termLogRatio(next->stats[changed[i]]);
+    }
+    next->freezeModel();
+
+    // Publish, and wait until no reader can still see the previous model.
+    published.store(&next->model);  // seq_cst, ordered before synchronize()'s new epoch
+    ReadCopyUpdate::synchronize();
+    state.keys.freeRetired();
+    state.live = 1 - state.live;
+    if (firstUpdate) {
+        // The trained or loaded tables have been copied, and no reader uses them any more.
+        counts = WordCounts();
+        std::vector<double>().swap(logLikelihoodRatios);
+        modelFile.close();
+    }
+}
+
+// TermStats records are written to and mapped from the model file as-is.
+static_assert(sizeof(TermStats) == 3 * sizeof(int), "TermStats must stay three packed ints for the model format");
+
+// Round an offset up to the next multiple of 8 (every model section is 8-byte aligned).
+static uint64_t alignTo8(uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// Write 'bytes' bytes at the current position, preceded by zero padding up to 'offset'.
+static void writeSection(std::ofstream& out, uint64_t& position, uint64_t offset, const void* data, uint64_t bytes) {
+    static const char zeros[8] = { 0 };
+    out.write(zeros, (std::streamsize)(offset - position));
+    if (bytes > 0) {
+        out.write((const char*)data, (std::streamsize)bytes);
+    }
+    position = offset + bytes;
+}
+
+// Save the model in the binary format described in ModelFormat.h.
+bool SentimentClassifier::save(const char* modelFileName) const {
+    // Write whichever model is published when save starts, even if update replaces it meanwhile.
+    ReadCopyUpdate::ReadGuard guard;
+    const ScoringModel& model = *published.load();
+    const StringHashIndex& termIndex = model.termIndex;
+    ModelFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+    header.version = MODEL_VERSION;
+    header.byteOrder = MODEL_BYTE_ORDER;
+    header.positiveTweetCount = model.positiveTweetCount;
+    header.negativeTweetCount = model.negativeTweetCount;
+    header.totalPositiveWords = model.totalPositiveWords;
+    header.totalNegativeWords = model.totalNegativeWords;
+    header.vocabularySize = model.vocabularySize;
+    header.logPriorRatio = model.logPriorRatio;
+    header.tokenLogRatio = model.tokenLogRatio;
+    header.termCount = termIndex.size;
+    header.slotCount = termIndex.slotCount;
+    header.keyBytes = (termIndex.keyOffsets != nullptr) ? termIndex.keyOffsets[termIndex.size] : 0;
+    
+    // Lay the sections out one after another, each 8-byte aligned.
+    header.slotsOffset = alignTo8(sizeof(header));
+    header.keyOffsetsOffset = alignTo8(header.slotsOffset + header.slotCount * sizeof(StringHashSlot));
+    header.termStatsOffset = alignTo8(header.keyOffsetsOffset + (header.termCount + 1) * sizeof(uint32_t));
+    header.logRatiosOffset = alignTo8(header.termStatsOffset + header.termCount * sizeof(TermStats));
+    header.keyPoolOffset = alignTo8(header.logRatiosOffset + header.termCount * sizeof(double));
+    header.fileSize = header.keyPoolOffset + header.keyBytes;
     
-    // Compare the log probabilities:
-    // If the positive log probability is greater than or equal to the negative, return 4 (positive sentiment).
-    // Otherwise, return 0 (negative sentiment).
-    return (logProbPositive >= logProbNegative) ? 4 : 0;
+    std::ofstream out(modelFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Unable to open model file " << modelFileName << " for writing." << std::endl;
+        return false;
+    }
+    uint64_t zeroOffset = 0;      // keyOffsets of an untrained model: a single 0
+    const uint32_t* keyOffsets = (termIndex.keyOffsets != nullptr) ? termIndex.keyOffsets : (const uint32_t*)&zeroOffset;
+    uint64_t position = 0;
+    writeSection(out, position, 0, &header, sizeof(header));
+    writeSection(out, position, header.slotsOffset, termIndex.slots, header.slotCount * sizeof(StringHashSlot));
+    writeSection(out, position, header.keyOffsetsOffset, keyOffsets, (header.termCount + 1) * sizeof(uint32_t));
+    writeSection(out, position, header.termStatsOffset, model.termStats, header.termCount * sizeof(TermStats));
+    writeSection(out, position, header.logRatiosOffset, model.termLogRatios, header.termCount * sizeof(double));
+    writeSection(out, position, header.keyPoolOffset, termIndex.keyPool, header.keyBytes);
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Unable to write model file " << modelFileName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Check that section [offset, offset + bytes) is aligned and lies inside a file of 'size' bytes.
+static bool sectionFits(uint64_t offset, uint64_t bytes, uint64_t size) {
+    return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+}
+
+// Check the tables a model's header points to, so lookups into them stay in bounds and
+// terminate: every slot is empty or names a term, at least one slot is empty (so a probe
+// for a missing key ends), and the key offsets rise from 0 to keyBytes. One pass over
+// the slots and one over the offsets.
+static bool tablesValid(const char* base, const ModelFileHeader& header) {
+    const StringHashSlot* slots = (const StringHashSlot*)(base + header.slotsOffset);
+    bool sawEmpty = false;
+    for (uint64_t i = 0; i < header.slotCount; i++) {
+        if (slots[i].index == StringHashIndex::EMPTY) {
+            sawEmpty = true;
+        } else if (slots[i].index >= header.termCount) {
+            return false;
+        }
+    }
+    if (header.termCount > 0 && !sawEmpty) {
+        return false;
+    }
+    const uint32_t* keyOffsets = (const uint32_t*)(base + header.keyOffsetsOffset);
+    if (keyOffsets[0] != 0) {
+        return false;
+    }
+    for (uint64_t i = 0; i < header.termCount; i++) {
+        if (keyOffsets[i + 1] < keyOffsets[i]) {
+            return false;
+        }
+    }
+    return keyOffsets[header.termCount] == header.keyBytes;
+}
+
+// Load a saved model by mapping it and pointing the scoring arrays into the mapping.
+bool SentimentClassifier::load(const char* modelFileName) {
+    MappedFile file;
+    if (!file.open(modelFileName, MappedFile::ACCESS_RANDOM)) {  // predict probes it at random
+        return false;
+    }
+    const char* base = file.begin();
+    uint64_t size = file.length();
+    
+    // Validate the header and the section bounds before trusting any of it.
+    ModelFileHeader header;
+    if (base == nullptr || size < sizeof(header)) {
+        std::cerr << "Error: " << modelFileName << " is not a sentiment model." << std::endl;
+        return false;
+    }
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, MODEL_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Error: " << modelFileName << " is not a sentiment model." << std::endl;
+        return false;
+    }
+    if (header.version != MODEL_VERSION || header.byteOrder != MODEL_BYTE_ORDER) {
+        std::cerr << "Error: " << modelFileName << " has an unsupported model version or byte order." << std::endl;
+        return false;
+    }
+    bool valid = header.fileSize == size
+        && header.termCount < StringHashIndex::EMPTY
+        && (header.slotCount & (header.slotCount - 1)) == 0
+        && (header.termCount == 0 || header.slotCount > header.termCount)
+        && header.slotCount <= size && header.termCount <= size
+        && sectionFits(header.slotsOffset, header.slotCount * sizeof(StringHashSlot), size)
+        && sectionFits(header.keyOffsetsOffset, (header.termCount + 1) * sizeof(uint32_t), size)
+        && sectionFits(header.termStatsOffset, header.termCount * sizeof(TermStats), size)
+        && sectionFits(header.logRatiosOffset, header.termCount * sizeof(double), size)
+        && sectionFits(header.keyPoolOffset, header.keyBytes, size);
+    if (valid) {
+        valid = tablesValid(base, header);
+    }
+    if (!valid) {
+        std::cerr << "Error: " << modelFileName << " is truncated or corrupt." << std::endl;
+        return false;
+    }
+    
+    // Drop any trained or updated tables and point predict at the mapped sections. The
+    // file's counts and totals live only in the loaded model: the tables training adds to
+    // start from zero, so a train call after load builds a new model.
+    counts = WordCounts();
+    logLikelihoodRatios.clear();
+    totalPositiveWords = 0;
+    totalNegativeWords = 0;
+    vocabularySize = 0;
+    model.positiveTweetCount = (int)header.positiveTweetCount;
+    model.negativeTweetCount = (int)header.negativeTweetCount;
+    model.totalPositiveWords = (int)header.totalPositiveWords;
+    model.totalNegativeWords = (int)header.totalNegativeWords;
+    model.vocabularySize = (int)header.vocabularySize;
+    model.logPriorRatio = header.logPriorRatio;
+    model.tokenLogRatio = header.tokenLogRatio;
+    model.termIndex.slots = (const StringHashSlot*)(base + header.slotsOffset);
+    model.termIndex.slotCount = (size_t)header.slotCount;
+    model.termIndex.keyOffsets = (const uint32_t*)(base + header.keyOffsetsOffset);
+    model.termIndex.keyPool = base + header.keyPoolOffset;
+    model.termIndex.size = (size_t)header.termCount;
+    model.termStats = (const TermStats*)(base + header.termStatsOffset);
+    model.termLogRatios = (const double*)(base + header.logRatiosOffset);
+    model.version = nextModelVersion();
+    modelFile.swap(file);         // Keep the mapping alive for as long as the model is in use.
+    published.store(&model);
+    updates.reset();
+    return true;
+}
+
+// Map each token of a tweet to its term ID in the published model.
+void SentimentClassifier::encode(const DSStringView& tweetText, std::vector<TermId>& termIds) const {
+    ReadCopyUpdate::ReadGuard guard;
+    encodeWith(*published.load(), tweetText, termIds);
+}
+
+// Map each token of a tweet to its term ID in 'scoring' (UNKNOWN_TERM if it was never seen
+// in training). Each thread keeps its own token cache; it is emptied whenever it is used
+// with a model other than the one its IDs came from, and resized when the configured
+// capacity changes.
+void SentimentClassifier::encodeWith(const ScoringModel& scoring, const DSStringView& tweetText,
+                                     std::vector<TermId>& termIds) const {
+    struct ThreadCache {
+        TokenCache cache;
+        uint64_t model;           // version of the model the cached IDs belong to
+        size_t capacity;          // capacity the cache was sized for
+        uint64_t owner;           // instanceId of the classifier 'counters' belongs to
+        CacheCounters* counters;  // this thread's counters in that classifier
+
+        ThreadCache() : cache(0), model(0), capacity(0), owner(0), counters(nullptr) {}
+    };
+    static thread_local ThreadCache local;
+    if (local.capacity != cacheCapacity) {
+        local.cache.resize(cacheCapacity);
+        local.capacity = cacheCapacity;
+        local.model = scoring.version;
+    } else if (local.model != scoring.version) {
+        local.cache.clear();
+        local.model = scoring.version;
+    }
+    const StringHashIndex& index = scoring.termIndex;
+    encodeWords(tweetText, local.cache, termIds, [&index](const DSStringView& term) {
+        size_t id = index.indexOf(term);
+        return (id != StringHashIndex::NOT_FOUND) ? (TermId)id : UNKNOWN_TERM;
+    });
+    // Publish this tweet's cache counts in this thread's own counters (nothing to do with
+    // the cache off).
+    const TokenCacheStats& stats = local.cache.stats();
+    if (stats.lookups() > 0) {
+        if (local.owner != instanceId) {
+            local.counters = threadCacheCounters();
+            local.owner = instanceId;
+        }
+        local.counters->add(stats);
+        local.cache.resetStats();
+    }
+}
+
+// The calling thread's counters, created on its first cached lookup with this classifier.
+// A thread that alternates between classifiers finds its block again by thread ID.
+SentimentClassifier::CacheCounters* SentimentClassifier::threadCacheCounters() const {
+    std::lock_guard<std::mutex> lock(cacheCountersMutex);
+    std::thread::id self = std::this_thread::get_id();
+    for (size_t i = 0; i < cacheCounters.size(); i++) {
+        if (cacheCounters[i]->owner == self) {
+            return cacheCounters[i].get();
+        }
+    }
+    cacheCounters.push_back(std::unique_ptr<CacheCounters>(new CacheCounters(self)));
+    return cacheCounters.back().get();
+}
+
+// Sum of every thread's counters (the caller holds cacheCountersMutex).
+TokenCacheStats SentimentClassifier::threadCacheStatsLocked() const {
+    TokenCacheStats sum;
+    for (size_t i = 0; i < cacheCounters.size(); i++) {
+        sum.hits += cacheCounters[i]->hits.load(std::memory_order_relaxed);
+        sum.misses += cacheCounters[i]->misses.load(std::memory_order_relaxed);
+        sum.uncached += cacheCounters[i]->uncached.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+// Add a training cache's counters to the classifier's totals (callable from any thread).
+void SentimentClassifier::addCacheStats(const TokenCacheStats& stats) const {
+    cacheHits.fetch_add(stats.hits, std::memory_order_relaxed);
+    cacheMisses.fetch_add(stats.misses, std::memory_order_relaxed);
+    cacheUncached.fetch_add(stats.uncached, std::memory_order_relaxed);
+}
+
+// Set the number of entries of the token caches created or resized from now on.
+void SentimentClassifier::setTokenCacheCapacity(size_t entries) {
+    cacheCapacity = entries;
+}
+
+size_t SentimentClassifier::tokenCacheCapacity() const {
+    return cacheCapacity;
+}
+
+// Snapshot of the token cache counters: the training runs' totals plus every thread's
+// encode counters since the last reset.
+TokenCacheStats SentimentClassifier::tokenCacheStats() const {
+    TokenCacheStats stats;
+    stats.hits = cacheHits.load(std::memory_order_relaxed);
+    stats.misses = cacheMisses.load(std::memory_order_relaxed);
+    stats.uncached = cacheUncached.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(cacheCountersMutex);
+    TokenCacheStats threads = threadCacheStatsLocked();
+    stats.hits += threads.hits - cacheCountersBaseline.hits;
+    stats.misses += threads.misses - cacheCountersBaseline.misses;
+    stats.uncached += threads.uncached - cacheCountersBaseline.uncached;
+    return stats;
+}
+
+// Zero the training totals; the threads' counters are left alone (only their owners
+// write them) and their current sums become the new baseline.
+void SentimentClassifier::resetTokenCacheStats() {
+    cacheHits.store(0, std::memory_order_relaxed);
+    cacheMisses.store(0, std::memory_order_relaxed);
+    cacheUncached.store(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(cacheCountersMutex);
+    cacheCountersBaseline = threadCacheStatsLocked();
+}
+
+// Log-odds of an encoded tweet under 'model': every token is an array index into the frozen ratios.
+static double scoreTerms(const ScoringModel& model, const std::vector<TermId>& termIds) {
+    // Start from the log prior ratio and the per-token part of every token's ratio, then
+    // add the per-term part of each known token (an unseen token has none).
+    double score = model.logPriorRatio + termIds.size() * model.tokenLogRatio;
+    for (size_t i = 0; i < termIds.size(); i++) {
+        score += (termIds[i] != UNKNOWN_TERM) ? model.termLogRatios[termIds[i]] : 0.0;
+    }
+    return score;
+}
+
+// Predict sentiment using a Naive Bayes approach.
+// The function returns 4 for positive sentiment and 0 for negative sentiment.
+int SentimentClassifier::predict(const DSStringView& tweetText) const {
+    // A non-negative score means log P(positive | tweet) >= log P(negative | tweet):
+    // return 4 (positive sentiment), otherwise 0 (negative sentiment).
+    return (score(tweetText) >= 0.0) ? 4 : 0;
+}
+
+// Predict the sentiment of an encoded tweet.
+int SentimentClassifier::predict(const std::vector<TermId>& termIds) const {
+    return (score(termIds) >= 0.0) ? 4 : 0;
+}
+
+// Log-odds of a tweet, encoded the same way predict encodes it. The tweet is encoded and
+// scored with the same published model, even if update publishes a new one meanwhile.
+double SentimentClassifier::score(const DSStringView& tweetText) const {
+    // Each thread encodes into its own ID vector, reused from tweet to tweet.
+    static thread_local std::vector<TermId> termIds;
+    ReadCopyUpdate::ReadGuard guard;
+    const ScoringModel& model = *published.load();
+    encodeWith(model, tweetText, termIds);
+    return scoreTerms(model, termIds);
+}
+
+// Log-odds of an encoded tweet.
+double SentimentClassifier::score(const std::vector<TermId>& termIds) const {
+    ReadCopyUpdate::ReadGuard guard;
+    return scoreTerms(*published.load(), termIds);
 }
 
 // Evaluate the classifier on the test data.
 // This function reads test tweets and ground truth, writes predictions to a results file,
 // writes accuracy and error details to an accuracy file, and returns the accuracy.
 float SentimentClassifier::evaluate(const char* testTweetsFile, const char* testSentimentFile, 
-                                      const char* resultsFile, const char* accuracyFile) {
-    // Read all lines from the test tweets file.
-    std::vector<DSString> tweetLines = FileIO::readLines(testTweetsFile);
-    // Read all lines from the ground truth (test sentiment) file.
-    std::vector<DSString> groundTruthLines = FileIO::readLines(testSentimentFile);
-    
-    // Build a mapping from tweet ID to the actual sentiment using the ground truth file.
-    std::map<DSString, int> groundTruth;
-    // For each line in the ground truth file...
-    for (size_t i = 0; i < groundTruthLines.size(); i++) {
-        // Tokenize the line using a comma as the delimiter.
-        std::vector<DSString> tokens = Tokenizer::tokenize(groundTruthLines[i], ',');
-        // If there are fewer than 2 tokens, skip this line.
-        if (tokens.size() < 2)
-            continue;
-        // Determine the actual sentiment: "4" means positive; otherwise, negative.
-        int sentiment = (tokens[0] == DSString("4")) ? 4 : 0;
-        // Extract the tweet ID from the second token.
-        DSString tweetID = tokens[1];
-        // Map the tweet ID to its corresponding sentiment.
-        groundTruth[tweetID] = sentiment;
+                                      const char* resultsFile, const char* accuracyFile, unsigned numThreads) {
+    // Map the ground truth (test sentiment) file and index it by tweet ID: numeric IDs in a
+    // flat integer hash table, anything else (such as a header line) by its text.
+    MappedFile groundTruthFile(testSentimentFile);
+    GroundTruthTable groundTruth;
+    groundTruth.load(groundTruthFile.view());
+    float accuracy = 0.0f;
+    scoreTestSet(testTweetsFile, groundTruth, resultsFile, accuracyFile, numThreads, false, accuracy);
+    return accuracy;
+}
+
+// Evaluate against test and ground-truth files that are both sorted by tweet ID.
+// The ground truth is merge-joined line by line instead of loaded, and error lines are
+// written as they are found, so memory does not grow with either file.
+bool SentimentClassifier::evaluateSorted(const char* testTweetsFile, const char* testSentimentFile,
+                                         const char* resultsFile, const char* accuracyFile, float& accuracy,
+                                         unsigned numThreads) {
+    GroundTruthMerge groundTruth;
+    groundTruth.open(testSentimentFile);  // A missing file just means no ground truth, as in evaluate
+    return scoreTestSet(testTweetsFile, groundTruth, resultsFile, accuracyFile, numThreads, true, accuracy);
+}
+
+// Delete an output file left incomplete by a failed evaluation. Only regular files are
+// removed, so an output sent to /dev/null or a pipe is left alone.
+static void removePartialOutput(const char* path) {
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISREG(st.st_mode)) {
+        unlink(path);
     }
+}
+
+// Score the test file and join every tweet with its ground truth (a GroundTruthTable or
+// a GroundTruthMerge). Both output files go through an AsyncFileWriter, so the lines are
+// formatted into large buffers and written to disk on a background thread while the
+// next block is scored. With 'streamErrors' the error lines go straight to the accuracy
+// file behind a placeholder accuracy line, which is overwritten at the end; the
+// accuracy always prints as five characters ("0.746"), so the file stays the same.
+// If the inputs turn out to be out of order, the partial output files are removed.
+template <typename Truth>
+bool SentimentClassifier::scoreTestSet(const char* testTweetsFile, Truth& groundTruth, const char* resultsFile,
+                                       const char* accuracyFile, unsigned numThreads, bool streamErrors,
+                                       float& accuracy) {
+    accuracy = 0.0f;
+    // Map the test tweets file into memory.
+    MappedFile tweetFile(testTweetsFile);
+    DSStringView tweetContents = tweetFile.view();
+    CsvRecord tokens;                  // Reused for the CSV fields of every line.
+    size_t offset = 0;
+    DSStringView line;
     
     // Open the results output file for writing predictions.
-    std::ofstream resultsOut(resultsFile);
+    AsyncFileWriter resultsOut;
     // Open the accuracy output file for writing overall accuracy and error details.
-    std::ofstream accuracyOut(accuracyFile);
-    // If either file fails to open, print an error and return 0.0 accuracy.
-    if (!resultsOut || !accuracyOut) {
+    AsyncFileWriter accuracyOut;
+    // If either file fails to open, print an error and fail with 0.0 accuracy.
+    if (!resultsOut.open(resultsFile) || !accuracyOut.open(accuracyFile)) {
         std::cerr << "Error: Unable to open results or accuracy output files." << std::endl;
-        return 0.0f;
+        return false;
+    }
+    if (streamErrors) {
+        accuracyOut.write("0.000\n", 6); // Placeholder for the accuracy, overwritten at the end.
     }
     
     int totalTweetsCount = 0;           // Counter for the number of tweets with available ground truth.
     int correct = 0;                    // Counter for correctly classified tweets.
-    std::vector<DSString> errorLines;   // Vector to store error lines for misclassified tweets.
-    
-    // Process each test tweet.
-    for (size_t i = 0; i < tweetLines.size(); i++) {
-        // Tokenize the test tweet line using a comma.
-        // Expected format: tweetID, date, query, username, tweet_text.
-        std::vector<DSString> tokens = Tokenizer::tokenize(tweetLines[i], ',');
-        // If the line doesn't have at least 5 tokens, skip it.
-        if (tokens.size() < 5)
-            continue;
-        // Extract the tweet ID (first token).
-        DSString tweetID = tokens[0];
-        // Extract the tweet text (fifth token).
-        DSString tweetText = tokens[4];
+    Arena errorText;                    // Holds the characters of the error lines, so keeping them does not allocate per line.
+    std::vector<DSStringView> errorLines; // Vector to store error lines for misclassified tweets.
+    
+    // The test set is scored in blocks: the records of a block are collected serially,
+    // predicted in parallel on the thread pool, and then written serially in input order,
+    // so the output is identical to scoring one tweet at a time.
+    ThreadPool pool(numThreads);
+    const size_t blockSize = 65536;     // Records per block (bounds memory on huge test sets).
+    const size_t grain = 256;           // Records per pool task.
+    std::vector<DSStringView> blockIDs;
+    std::vector<DSStringView> blockTexts;
+    std::vector<int> blockPredictions;
+    size_t testLines = FileIO::countLines(tweetContents);
+    blockIDs.reserve(testLines < blockSize ? testLines : blockSize);  // Sized once, not grown per record
+    blockTexts.reserve(blockIDs.capacity());
+    blockPredictions.reserve(blockIDs.capacity());
+    
+    offset = 0;
+    bool moreLines = true;
+    while (moreLines) {
+        // Collect the next block of test tweets as views into the mapped file.
+        blockIDs.clear();
+        blockTexts.clear();
+        while (blockIDs.size() < blockSize) {
+            if (!FileIO::nextLine(tweetContents, offset, line)) {
+                moreLines = false;
+                break;
+            }
+            // Split the test tweet line into its CSV fields (the text may be quoted and contain commas).
+            // Expected format: tweetID, date, query, username, tweet_text.
+            tokens.parse(line);
+            // If the line doesn't have at least 5 tokens, skip it.
+            if (tokens.size() < 5)
+                continue;
+            blockIDs.push_back(tokens[0]);    // The tweet ID (first token).
+            blockTexts.push_back(tokens[4]);  // The tweet text (fifth token).
+        }
         
-        // Predict the sentiment for the tweet text.
-        int predicted = predict(tweetText);
-        // Write the predicted sentiment and tweet ID to the results file in the format: predicted, tweetID.
-        resultsOut << predicted << ", " << tweetID << std::endl;
+        // Predict the sentiment of every tweet in the block in parallel; predict is const,
+        // so the workers can share this classifier.
+        blockPredictions.resize(blockTexts.size());
+        pool.parallelFor(blockTexts.size(), grain, [this, &blockTexts, &blockPredictions](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                blockPredictions[i] = predict(blockTexts[i]);
+            }
+        });
         
-        // If ground truth exists for this tweet...
-        if (groundTruth.find(tweetID) != groundTruth.end()) {
-            totalTweetsCount++;       // Increment the counter of tweets with ground truth.
-            int actual = groundTruth[tweetID]; // Retrieve the actual sentiment from the ground truth map.
-            if (predicted == actual) {
-                correct++;            // If the prediction matches the actual sentiment, increment the correct counter.
-            } else {
-                // If the prediction is incorrect, create an error line in the format: actual, predicted, tweetID.
-                DSString errorLine((std::to_string(actual) + ", " +
-                                    std::to_string(predicted) + ", " +
-                                    tweetID.c_str()).c_str());
-                // Add the error line to the vector of error lines.
-                errorLines.push_back(errorLine);
+        // Write the results and tally accuracy in input order.
+        for (size_t i = 0; i < blockIDs.size(); i++) {
+            const DSStringView& tweetID = blockIDs[i];
+            int predicted = blockPredictions[i];
+            // Write the predicted sentiment and tweet ID to the results file in the format: predicted, tweetID.
+            resultsOut.writeInt(predicted);
+            resultsOut.write(", ", 2);
+            resultsOut.write(tweetID);
+            resultsOut.put('\n');
+            
+            // If ground truth exists for this tweet...
+            int actual = 0;
+            GroundTruthResult truth = groundTruth.lookup(TweetId::parse(tweetID), actual);
+            if (truth == TRUTH_OUT_OF_ORDER) {
+                std::cerr << "Error: the test and ground-truth files are not sorted by tweet ID." << std::endl;
+                resultsOut.close();
+                accuracyOut.close();
+                removePartialOutput(resultsFile);
+                removePartialOutput(accuracyFile);
+                return false;
+            }
+            if (truth == TRUTH_FOUND) {
+                totalTweetsCount++;       // Increment the counter of tweets with ground truth.
+                if (predicted == actual) {
+                    correct++;            // If the prediction matches the actual sentiment, increment the correct counter.
+                } else if (streamErrors) {
+                    accuracyOut.writeInt(actual);
+                    accuracyOut.write(", ", 2);
+                    accuracyOut.writeInt(predicted);
+                    accuracyOut.write(", ", 2);
+                    accuracyOut.write(tweetID);
+                    accuracyOut.put('\n');
+                } else {
+                    // If the prediction is incorrect, create an error line in the format: actual, predicted, tweetID.
+                    char prefix[2 * AsyncFileWriter::MAX_INT_LENGTH + 4];
+                    size_t prefixLength = AsyncFileWriter::formatInt(actual, prefix);
+                    prefix[prefixLength++] = ',';
+                    prefix[prefixLength++] = ' ';
+                    prefixLength += AsyncFileWriter::formatInt(predicted, prefix + prefixLength);
+                    prefix[prefixLength++] = ',';
+                    prefix[prefixLength++] = ' ';
+                    char* errorLine = errorText.allocate(prefixLength + tweetID.length());
+                    memcpy(errorLine, prefix, prefixLength);
+                    memcpy(errorLine + prefixLength, tweetID.data(), tweetID.length());
+                    // Add the error line to the vector of error lines.
+                    errorLines.push_back(DSStringView(errorLine, prefixLength + tweetID.length()));
+                }
             }
         }
     }
     
     // Calculate the overall accuracy as the ratio of correct predictions to the total tweets with ground truth.
-    float accuracy = (totalTweetsCount > 0) ? (float)correct / totalTweetsCount : 0.0f;
+    accuracy = (totalTweetsCount > 0) ? (float)correct / totalTweetsCount : 0.0f;
     // Write the accuracy (formatted with exactly three decimal places) on the first line of the accuracy file.
-    accuracyOut << std::fixed << std::setprecision(3) << accuracy << std::endl;
+    char accuracyText[32];
+    int accuracyLength = snprintf(accuracyText, sizeof(accuracyText), "%.3f", accuracy);
+    if (streamErrors) {
+        accuracyOut.writeAt(0, accuracyText, accuracyLength); // Over the placeholder, which has the same width
+    } else {
+        accuracyOut.write(accuracyText, accuracyLength);
+        accuracyOut.put('\n');
+    }
     // Write each error line (misclassified tweet details) to the accuracy file.
     for (size_t i = 0; i < errorLines.size(); i++) {
-        accuracyOut << errorLines[i] << std::endl;
+        accuracyOut.write(errorLines[i]);
+        accuracyOut.put('\n');
     }
     
-    // Close the results and accuracy output files.
-    resultsOut.close();
-    accuracyOut.close();
+    // Close the results and accuracy output files (waiting for the last writes).
+    bool resultsWritten = resultsOut.close();
+    bool accuracyWritten = accuracyOut.close();
+    if (!resultsWritten || !accuracyWritten) {
+        std::cerr << "Error: Unable to write results or accuracy output files." << std::endl;
+    }
     
-    // Return the calculated accuracy.
-    return accuracy;
+    // The calculated accuracy is in 'accuracy'.
+    return resultsWritten && accuracyWritten;
 }
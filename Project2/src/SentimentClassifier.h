@@ -2,43 +2,280 @@
 #define SENTIMENTCLASSIFIER_H
 
 #include <vector>
-#include <map>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include "DSString.h"
+#include "DSStringView.h"
+#include "ChunkedLineReader.h"
+#include "CsvRecord.h"
+#include "StringInterner.h"
+#include "MappedFile.h"
+#include "TokenCache.h"
 
-class SentimentClassifier {
-private:
-    // Word frequency maps for positive and negative tweets.
-    std::map<DSString, int> positiveWords;
-    std::map<DSString, int> negativeWords;
+// Snapshot of how far a training run has come.
+struct TrainingProgress {
+    unsigned long long records;  // lines processed so far
+    unsigned long long bytes;    // input bytes processed so far
+    double seconds;              // time since training started (or total time, once finished)
+    bool running;                // true while a train call is in progress
+
+    double recordsPerSecond() const;
+    double megabytesPerSecond() const;
+};
+
+// Dense ID of a vocabulary term (its index in the term dictionary). Every per-term
+// table is a plain array indexed by it.
+typedef uint32_t TermId;
+
+// Stands for a token that is not in the vocabulary.
+static const TermId UNKNOWN_TERM = 0xFFFFFFFFu;
+
+// Everything the model knows about one vocabulary term.
+struct TermStats {
+    int positive;      // occurrences in positive tweets
+    int negative;      // occurrences in negative tweets
+    int documents;     // number of training tweets that contain the term
+
+    TermStats() : positive(0), negative(0), documents(0) {}
+};
+
+// Raw counts gathered from training tweets. trainParallel gives every worker
+// its own WordCounts and merges them at the end.
+struct WordCounts {
+    // The term dictionary: every vocabulary word is stored once and gets a TermId.
+    StringInterner terms;
+
+    // stats[id] holds both class counts of term 'id', so scoring needs a single
+    // dictionary lookup per token and everything after it is array indexing.
+    std::vector<TermStats> stats;
     
     // Count of tweets in each class.
     int positiveTweetCount;
     int negativeTweetCount;
+
+    WordCounts();
+
+    // ID of 'term', adding it (with zero counts) if it is new.
+    TermId internTerm(const DSStringView& term);
+
+    // Adds all counts of 'other' to this one.
+    void merge(const WordCounts& other);
+};
+
+// Everything predict and save read, bundled so a whole model can be replaced by
+// storing a single pointer (see SentimentClassifier::update).
+struct ScoringModel {
+    // With Laplace smoothing, log P(term | positive) - log P(term | negative) splits into
+    // a part that only depends on the term's own counts,
+    //     termLogRatios[id] = log(positive + alpha) - log(negative + alpha),
+    // indexed by TermId, and a part that is the same for every token,
+    //     tokenLogRatio = log(totalNegativeWords + alpha * V) - log(totalPositiveWords + alpha * V),
+    // which is also the whole ratio of a token never seen in training. Scoring a token is
+    // one lookup and one add, and new counts only change the ratios of their own terms.
+    StringHashIndex termIndex;
+    const TermStats* termStats;
+    const double* termLogRatios;
+    double tokenLogRatio;
+    double logPriorRatio;    // log P(positive) - log P(negative)
+
+    // The counts the ratios were computed from (written to the model file).
+    int positiveTweetCount;
+    int negativeTweetCount;
+    int totalPositiveWords;
+    int totalNegativeWords;
+    int vocabularySize;
+
+    // Identifies the model (unique across all classifiers in the process), so the
+    // per-thread token caches of predict can tell when their term IDs went stale.
+    uint64_t version;
+
+    ScoringModel();
+};
+
+class SentimentClassifier {
+private:
+    // Word and tweet counts for both classes.
+    WordCounts counts;
     
     // New members for Naive Bayes calculations.
     int totalPositiveWords;
     int totalNegativeWords;
     int vocabularySize;
-    
-    // New: document frequency for tokens.
-    std::map<DSString, int> tokenDocFrequency;
+
+    // Frozen scoring model, rebuilt by freeze() after every training run. Its arrays
+    // point into 'counts' and 'logLikelihoodRatios' after training, and straight into
+    // 'modelFile' after load().
+    ScoringModel model;
+    std::vector<double> logLikelihoodRatios;
+    MappedFile modelFile;
+
+    // The model readers use: 'model', or the model update() published last. Readers load
+    // it inside a ReadCopyUpdate::ReadGuard, so update() knows when no reader can still
+    // see a model it replaced. update() keeps two copies of the per-term tables and the
+    // term keys they share (null until the first update).
+    struct ModelSnapshot;
+    struct UpdateState;
+    std::atomic<const ScoringModel*> published;
+    std::unique_ptr<UpdateState> updates;
+    std::mutex updateMutex;       // serializes update() calls
+
+    // Entries of each token cache (training scratch and per-thread predict caches); 0 disables them.
+    size_t cacheCapacity;
+
+    // Token cache counters of all training runs and update calls, added up once per run.
+    mutable std::atomic<unsigned long long> cacheHits;
+    mutable std::atomic<unsigned long long> cacheMisses;
+    mutable std::atomic<unsigned long long> cacheUncached;
+
+    // Token cache counters of encode and predict: one block per thread that used this
+    // classifier, written only by that thread, so the hot path never contends on a
+    // shared cache line. They are summed when the stats are read; the sums at the last
+    // reset are subtracted.
+    struct CacheCounters;
+    mutable std::mutex cacheCountersMutex;
+    mutable std::vector<std::unique_ptr<CacheCounters> > cacheCounters;
+    mutable TokenCacheStats cacheCountersBaseline;
+    uint64_t instanceId;          // unique across all classifiers in the process
+
+    // Training progress, updated as records are processed and readable from other threads.
+    std::atomic<unsigned long long> progressRecords;
+    std::atomic<unsigned long long> progressBytes;
+    std::atomic<long long> progressStartNanos;
+    std::atomic<long long> progressEndNanos;   // 0 while training is running
 
     // Helper functions.
-    void processTrainingTweet(const DSString& tweetLine);
-    std::vector<DSString> tokenizeTweet(const DSString& tweetText);
+    void beginProgress();
+    void recordProgress(size_t lineBytes);
+    void endProgress();
+    void computeTotals();
+    void freeze();
+    void beginUpdates();
+    void encodeWith(const ScoringModel& scoring, const DSStringView& tweetText, std::vector<TermId>& termIds) const;
+    void addCacheStats(const TokenCacheStats& stats) const;
+    CacheCounters* threadCacheCounters() const;
+    TokenCacheStats threadCacheStatsLocked() const;
+    // Scratch space for processing training lines, reused across lines by the caller.
+    struct TrainingScratch {
+        CsvRecord fields;                  // the CSV fields of the line
+        std::vector<TermId> termIds;       // the tweet's tokens as term IDs
+        TokenCache cache;                  // raw word -> term ID in the target's dictionary
+        std::vector<int> lastDocument;     // term ID -> last tweet counted in its 'documents'
+
+        explicit TrainingScratch(size_t cacheCapacity) : cache(cacheCapacity) {}
+    };
+    // The tweet is counted into 'target' (the model's own counts, a worker's shard, or
+    // the tables update() is about to publish).
+    template <typename Counts>
+    void processTrainingTweet(const DSStringView& tweetLine, TrainingScratch& scratch, Counts& target);
+    void processTrainingRange(const DSStringView& lines, WordCounts& target);
+    // Scores the test file and joins it with 'groundTruth' (a GroundTruthTable or GroundTruthMerge).
+    // Returns false if the output files cannot be opened or the inputs are out of order.
+    template <typename Truth>
+    bool scoreTestSet(const char* testTweetsFile, Truth& groundTruth, const char* resultsFile,
+                      const char* accuracyFile, unsigned numThreads, bool streamErrors, float& accuracy);
     
 public:
     SentimentClassifier();
+    ~SentimentClassifier();
     
-    // Train using the training file.
-    void train(const char* trainingFile);
+    // Train using the training file. Returns false, after printing an error and leaving
+    // the classifier unchanged, if the file cannot be opened; the same holds for the
+    // other train variants.
+    bool train(const char* trainingFile);
+
+    // Train by streaming the file through a fixed-size buffer instead of mapping it whole.
+    // Each record is processed as soon as it is parsed, so memory is bounded by the
+    // vocabulary size, not the corpus size; use this for inputs larger than RAM.
+    bool trainStreaming(const char* trainingFile, size_t chunkSize = ChunkedLineReader::DEFAULT_CHUNK_SIZE);
+
+    // Train on 'numThreads' threads (0 = one per hardware thread). The file is split into
+    // byte ranges on line boundaries, every worker counts its range into private tables,
+    // and the tables are merged at the end; the model is identical to train()'s.
+    bool trainParallel(const char* trainingFile, unsigned numThreads = 0);
+
+    // Add labeled tweets (lines in the training file's format) to the trained or loaded
+    // model without retraining; the model then equals one trained on the old and the new
+    // tweets together. Scoring is never paused: update keeps two copies of the per-term
+    // tables, counts the new tweets into the one readers do not use and publishes it,
+    // and the next update first copies those changes over to the other one. Only the
+    // terms of the new tweets are touched (the totals only change the per-token ratio),
+    // and the term keys are shared by both copies and only appended to, so an update
+    // costs time proportional to the new tweets' tokens. The first update copies the
+    // model's tables once, and the one after it copies them again for the second table.
+    // Any number of threads may call predict, encode, score or save during an update;
+    // calls to update are serialized. A train call after an update starts a new model.
+    void update(const std::vector<DSStringView>& trainingLines);
+
+    // Save the trained (or loaded) model to a compact, versioned binary file (see ModelFormat.h).
+    // Returns false if the file cannot be written.
+    bool save(const char* modelFile) const;
+
+    // Load a model written by save(). The file is memory-mapped and predict reads its
+    // sections in place; loading costs a few system calls and one validation pass over the
+    // probe table and key offsets (so a corrupt file cannot make lookups run out of bounds).
+    // Returns false (leaving the classifier unchanged) if the file is missing or invalid.
+    // A loaded model can be extended with update(); a train call right after load starts a
+    // new model from scratch.
+    bool load(const char* modelFile);
+
+    // Progress of the current (or last) training run; safe to call from another thread
+    // while any train variant is running.
+    TrainingProgress trainingProgress() const;
     
     // Predict the sentiment (4 for positive, 0 for negative) using Naive Bayes.
-    int predict(const DSString& tweetText);
+    // The tweet is positive when logPriorRatio plus the tokens' log-likelihood ratios is >= 0.
+    // predict only reads the model, so any number of threads may call it concurrently on
+    // one trained classifier (as long as no train or load call runs at the same time, but
+    // update may).
+    // Takes a view, so tweet text can be scored straight out of a mapped file (a DSString
+    // converts implicitly).
+    int predict(const DSStringView& tweetText) const;
+
+    // Tokenizes a tweet exactly like predict and stores its tokens as term IDs in
+    // 'termIds' (UNKNOWN_TERM for words outside the vocabulary). A tweet encoded once
+    // can be scored any number of times without touching its text again.
+    void encode(const DSStringView& tweetText, std::vector<TermId>& termIds) const;
+
+    // Predict the sentiment of an encoded tweet; the same result as predict on its text.
+    // Term IDs stay valid across update calls (new terms only get new IDs).
+    int predict(const std::vector<TermId>& termIds) const;
+
+    // The score predict compares with 0: the log prior ratio plus the log-likelihood
+    // ratios of the tweet's tokens, i.e. log P(positive | tweet) - log P(negative | tweet).
+    double score(const DSStringView& tweetText) const;
+    double score(const std::vector<TermId>& termIds) const;
+
+    // Training and encoding look every word of a tweet up in a bounded cache from its raw
+    // bytes to its term ID, and only normalize the words the cache does not know. Each
+    // training run has its own cache, and every thread that calls encode or predict has
+    // one that is cleared whenever the model changes. Sets the number of entries per cache
+    // (0, the default, turns caching off; TokenCache::DEFAULT_CAPACITY is a good size
+    // when `sentiment_bench tokencache` shows a gain). The results never depend on it.
+    // Do not call it while train, encode or predict are running.
+    void setTokenCacheCapacity(size_t entries);
+    size_t tokenCacheCapacity() const;
+
+    // Hits and misses of the token caches over all training runs and predict calls.
+    TokenCacheStats tokenCacheStats() const;
+    void resetTokenCacheStats();
     
     // Evaluate the classifier on the test files.
+    // Tweets are scored on 'numThreads' threads (0 = one per hardware thread); the output
+    // files are written in input order and do not depend on the thread count.
     float evaluate(const char* testTweetsFile, const char* testSentimentFile, 
-                   const char* resultsFile, const char* accuracyFile);
+                   const char* resultsFile, const char* accuracyFile, unsigned numThreads = 0);
+
+    // Same as evaluate, for test and ground-truth files that are both sorted by tweet ID
+    // (as numbers; IDs that are not plain numbers, such as a header's "id", sort first).
+    // The ground truth is merge-joined while it is streamed, and error lines are written
+    // as they are found, so memory does not depend on the size of either file. The
+    // accuracy file must be seekable (a regular file or /dev/null). Returns true and sets
+    // 'accuracy' on success. If either file turns out not to be sorted, an error is
+    // printed, the partial output files are removed, and false is returned; false is also
+    // returned if an output file cannot be opened or written.
+    bool evaluateSorted(const char* testTweetsFile, const char* testSentimentFile,
+                        const char* resultsFile, const char* accuracyFile, float& accuracy, unsigned numThreads = 0);
 };
 
 #endif // SENTIMENTCLASSIFIER_H
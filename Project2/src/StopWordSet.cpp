@@ -0,0 +1,148 @@
+#include "StopWordSet.h"    // Include the header file for the StopWordSet class
+#include "StringInterner.h"    // Include StringInterner to drop duplicate words in linear time
+#include <algorithm>           // Include algorithm for std::sort() and std::find() while placing buckets
+
+// ASCII lowercase of one byte (std::tolower in the "C" locale).
+static inline char asciiLower(char c) {
+    return ((unsigned char)(c - 'A') < 26) ? (char)(c | 0x20) : c;
+}
+
+// Seeds tried before giving up, and the largest d0 and d1 of a displacement. Slots are
+// taken modulo the slot count, so larger values than the slot count repeat earlier ones.
+static const uint64_t MAX_SEEDS = 64;
+static const uint32_t MAX_DISPLACEMENT_PART = 1024;
+
+// Store the distinct lowercase words, then build the table under the first seed that works.
+StopWordSet::StopWordSet(const char* const* list, size_t count)
+    : seed(0), slotMask(0), bucketMask(0), words(0), minLength((size_t)-1), maxLength(0) {
+    offsets.push_back(0);
+    std::vector<char> lowered;
+    StringInterner distinct;      // Finds duplicates in O(1) each
+    for (size_t i = 0; i < count; i++) {
+        lowered.assign(list[i], list[i] + strlen(list[i]));
+        for (size_t j = 0; j < lowered.size(); j++) {
+            lowered[j] = asciiLower(lowered[j]);
+        }
+        DSStringView word(lowered.data(), lowered.size());
+        if (distinct.intern(word) != words) {
+            continue;             // Seen before
+        }
+        pool.insert(pool.end(), lowered.begin(), lowered.end());
+        offsets.push_back((uint32_t)pool.size());
+        words++;
+        if (word.length() < minLength) {
+            minLength = word.length();
+        }
+        if (word.length() > maxLength) {
+            maxLength = word.length();
+        }
+    }
+    offsets.push_back((uint32_t)pool.size());  // The empty entry that empty slots point at
+
+    std::vector<uint64_t> hashes(words);
+    for (uint64_t trySeed = 0; trySeed < MAX_SEEDS; trySeed++) {
+        for (size_t w = 0; w < words; w++) {
+            DSStringView word = wordAt(w);
+            hashes[w] = hash(word.data(), word.length(), trySeed);
+        }
+        if (build(trySeed, hashes)) {
+            return;
+        }
+    }
+    slots.clear();                // ok() tells the caller; the set is empty meanwhile
+    displacements.clear();
+    minLength = (size_t)-1;       // contains() now rejects every token before touching the table
+    maxLength = 0;
+}
+
+// One CHD attempt under 'trySeed': group the words into buckets of about four, then,
+// largest bucket first, find a displacement that puts every word of the bucket into a
+// free slot. Returns false if two words of a bucket cannot be separated or a bucket
+// runs out of displacements.
+bool StopWordSet::build(uint64_t trySeed, const std::vector<uint64_t>& hashes) {
+    seed = trySeed;
+    size_t slotCount = 16;
+    while (slotCount < words + words / 4) {
+        slotCount *= 2;
+    }
+    size_t bucketCount = 1;
+    while (bucketCount * 4 < words) {
+        bucketCount *= 2;
+    }
+    slotMask = slotCount - 1;
+    bucketMask = bucketCount - 1;
+    slots.assign(slotCount, (uint32_t)words);
+    displacements.assign(bucketCount, 0);
+
+    // The words of each bucket, as ranges of one array sorted by bucket.
+    std::vector<uint32_t> bucketStart(bucketCount + 1, 0);
+    for (size_t w = 0; w < words; w++) {
+        bucketStart[bucketOf(hashes[w]) + 1]++;
+    }
+    for (size_t b = 0; b < bucketCount; b++) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    std::vector<uint32_t> members(words);
+    std::vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t w = 0; w < words; w++) {
+        members[fill[bucketOf(hashes[w])]++] = (uint32_t)w;
+    }
+    std::vector<uint32_t> order(bucketCount);
+    for (size_t b = 0; b < bucketCount; b++) {
+        order[b] = (uint32_t)b;
+    }
+    std::sort(order.begin(), order.end(), [&bucketStart](uint32_t a, uint32_t b) {
+        return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+    });
+
+    std::vector<size_t> taken;    // slots of the bucket being placed
+    for (size_t o = 0; o < bucketCount; o++) {
+        uint32_t b = order[o];
+        uint32_t begin = bucketStart[b];
+        uint32_t end = bucketStart[b + 1];
+        if (begin == end) {
+            break;                // Sorted by size: the rest are empty too
+        }
+        uint32_t parts = (slotCount < MAX_DISPLACEMENT_PART) ? (uint32_t)slotCount : MAX_DISPLACEMENT_PART;
+        bool placed = false;
+        for (uint32_t tried = 0; tried < parts * parts && !placed; tried++) {
+            uint32_t displacement = ((tried / parts) << 16) | (tried % parts);
+            taken.clear();
+            placed = true;
+            for (uint32_t m = begin; m < end && placed; m++) {
+                size_t slot = slotOf(hashes[members[m]], displacement);
+                placed = slots[slot] == words && std::find(taken.begin(), taken.end(), slot) == taken.end();
+                taken.push_back(slot);
+            }
+            if (placed) {
+                displacements[b] = displacement;
+                for (uint32_t m = begin; m < end; m++) {
+                    slots[taken[m - begin]] = members[m];
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StopWordSet::containsIgnoringCase(const DSStringView& token) const {
+    size_t length = token.length();
+    if (length < minLength || length > maxLength) {
+        return false;
+    }
+    char lowered[256];
+    if (length > sizeof(lowered)) {
+        std::vector<char> copy(token.data(), token.data() + length);  // Only for absurdly long stop words
+        for (size_t i = 0; i < length; i++) {
+            copy[i] = asciiLower(copy[i]);
+        }
+        return contains(DSStringView(copy.data(), length));
+    }
+    for (size_t i = 0; i < length; i++) {
+        lowered[i] = asciiLower(token[i]);
+    }
+    return contains(DSStringView(lowered, length));
+}
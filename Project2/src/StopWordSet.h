@@ -0,0 +1,99 @@
+#ifndef STOPWORDSET_H
+#define STOPWORDSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "DSStringView.h"
+
+// Fixed set of (lowercase) words in a minimal-size perfect hash table, for testing every
+// token of every tweet against a stop-word list. The table is built once from a word
+// list with the CHD scheme (compress, hash, displace): the words are hashed into small
+// buckets, and each bucket, largest first, gets a displacement that moves all of its
+// words into free slots of a power-of-two table with 1.25 to 2.5 slots per word. contains() is then
+// one seeded hash, one displacement read, one slot read and one compare, whatever the
+// size of the list, and the table grows linearly with the list. Lookups never allocate
+// and the set is read-only, so it can be shared between threads.
+class StopWordSet {
+private:
+    std::vector<uint32_t> slots;          // word index per slot; 'words' (the count) marks an empty slot
+    std::vector<uint32_t> displacements;  // per bucket: (d0 << 16) | d1, see slotOf
+    std::vector<uint32_t> offsets;  // words + 2 offsets into pool: word i is pool[offsets[i] .. offsets[i + 1])
+    std::vector<char> pool;         // the words' bytes back to back
+    uint64_t seed;                  // hash seed under which every bucket found a displacement
+    size_t slotMask;                // slot count - 1 (a power of two)
+    size_t bucketMask;              // bucket count - 1 (a power of two)
+    size_t words;                   // number of distinct words
+    size_t minLength;               // shortest and longest word, for a quick reject
+    size_t maxLength;
+
+    // 64-bit hash of a word under 'seed'. The seed starts the mixing, so words that
+    // collide under one seed are separated by another.
+    static uint64_t hash(const char* key, size_t length, uint64_t seed) {
+        const uint64_t k = 0x9E3779B97F4A7C15ull;
+        uint64_t h = (seed ^ length) * k;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            memcpy(&word, key + i, 8);
+            h = (h ^ word) * k;
+            h ^= h >> 29;
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, key + i, length - i);
+        h = (h ^ tail) * k;
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // The bucket of a hash, and its slot under a bucket's displacement: the slot is
+    // f1 + d0 * f2 + d1 (mod the slot count), with f1 and f2 (odd) taken from the hash.
+    size_t bucketOf(uint64_t h) const {
+        return (size_t)(h >> 40) & bucketMask;
+    }
+    size_t slotOf(uint64_t h, uint32_t displacement) const {
+        uint32_t f1 = (uint32_t)h;
+        uint32_t f2 = (uint32_t)((h * 0xC2B2AE3D27D4EB4Full) >> 32) | 1u;
+        return (size_t)(f1 + (displacement >> 16) * f2 + (displacement & 0xFFFFu)) & slotMask;
+    }
+
+    bool build(uint64_t trySeed, const std::vector<uint64_t>& hashes);
+public:
+    // Builds the set from 'count' null-terminated words (lowercased; duplicates ignored).
+    // If no seed works (practically impossible), the set stays empty and ok() returns
+    // false; the caller must check it, since an empty set silently keeps every word.
+    StopWordSet(const char* const* list, size_t count);
+
+    // False if the table could not be built.
+    bool ok() const { return !slots.empty(); }
+
+    // Number of distinct words.
+    size_t size() const { return words; }
+
+    // The i-th distinct word (in list order), lowercased.
+    DSStringView wordAt(size_t i) const {
+        return DSStringView(pool.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    // True if the lowercase token is one of the words.
+    bool contains(const DSStringView& lowerToken) const {
+        size_t length = lowerToken.length();
+        if (length < minLength || length > maxLength) {
+            return false;
+        }
+        // An empty slot holds index 'words', whose entry is the empty string past the
+        // last word, so a miss fails the length check below without a separate branch.
+        uint64_t h = hash(lowerToken.data(), length, seed);
+        uint32_t word = slots[slotOf(h, displacements[bucketOf(h)])];
+        uint32_t start = offsets[word];
+        return offsets[word + 1] - start == length && memcmp(pool.data() + start, lowerToken.data(), length) == 0;
+    }
+
+    // True if the token is one of the words when lowercased (ASCII).
+    bool containsIgnoringCase(const DSStringView& token) const;
+};
+
+#endif // STOPWORDSET_H
@@ -0,0 +1,241 @@
+#include "StreamClassifier.h"  // Include the header file for the StreamClassifier class
+#include "AsyncFileWriter.h"      // Include AsyncFileWriter for the writing stage of the pipeline
+#include "CsvRecord.h"            // Include CsvRecord for the fields of CSV input lines
+#include "FileIO.h"               // Include FileIO for line iteration over a batch
+#include <cerrno>                 // Include cerrno to retry reads interrupted by a signal
+#include <cmath>                  // Include cmath for llround() and isfinite() when formatting scores
+#include <cstdio>                 // Include cstdio for snprintf() of very large scores
+#include <cstring>                // Include cstring for memchr(), memrchr(), memcpy() and strlen()
+#include <iostream>               // Include iostream for error messages (std::cerr)
+#include <thread>                 // Include thread for the reader stage
+#include <unistd.h>               // Include unistd.h for read()
+
+// Append a score with four decimals ("-1.2346"), formatted by hand like the integers.
+// A score that is not finite is written as "nan", "inf" or "-inf", and one too large
+// for a scaled long long through snprintf, so both print what "%.4f" would.
+static void writeScore(AsyncFileWriter& out, double score) {
+    if (!std::isfinite(score)) {
+        const char* token = std::isnan(score) ? "nan" : (score < 0 ? "-inf" : "inf");
+        out.write(token, strlen(token));
+        return;
+    }
+    if (fabs(score) >= 1e14) {
+        char text[352];               // Enough for any double with four decimals
+        int n = snprintf(text, sizeof(text), "%.4f", score);
+        out.write(text, (size_t)n);
+        return;
+    }
+    long long scaled = llround(score * 10000.0);
+    if (scaled < 0) {
+        out.put('-');
+        scaled = -scaled;
+    }
+    out.writeInt(scaled / 10000);
+    char fraction[5] = { '.', 0, 0, 0, 0 };
+    long long decimals = scaled % 10000;
+    for (int i = 4; i >= 1; i--) {
+        fraction[i] = (char)('0' + decimals % 10);
+        decimals /= 10;
+    }
+    out.write(fraction, sizeof(fraction));
+}
+
+// Constructor: remember the options; the batches are allocated by the first run.
+StreamClassifier::StreamClassifier(const SentimentClassifier& classifier, InputFormat format, bool withScores,
+                                   size_t batchBytes, size_t maxLineBytes)
+    : classifier(classifier), format(format), withScores(withScores), batchBytes(batchBytes > 0 ? batchBytes : 1),
+      maxLineBytes(maxLineBytes > this->batchBytes ? maxLineBytes : this->batchBytes), fullHead(0), fullCount(0), freeCount(0), readFailed(false),
+      lines(0), classified(0), truncated(0) {
+}
+
+// Hand a filled batch to the scorer.
+void StreamClassifier::queueFull(size_t index) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fullIndex[(fullHead + fullCount) % BATCH_COUNT] = index;
+        fullCount++;
+    }
+    batchFilled.notify_one();
+}
+
+// Reader stage: fill free batches with whole lines. A batch is handed on as soon as a
+// read completes a line, so a slow producer's lines are not held back; the partial line
+// at its end is carried over to the start of the next batch. A line that reaches
+// maxLineBytes without a newline is cut there: its first maxLineBytes bytes are handed on
+// as a line of their own and the rest of it is dropped as it arrives.
+void StreamClassifier::readerLoop(int inputFd) {
+    std::vector<char> carry;      // the unfinished last line of the previous batch
+    bool skipping = false;        // dropping the rest of a line that was cut
+    for (;;) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchFreed.wait(lock, [this] { return freeCount > 0; });
+            index = freeIndex[--freeCount];
+        }
+        Batch& batch = batches[index];
+        if (batch.bytes.size() < batchBytes || batch.bytes.size() < 2 * carry.size()) {
+            batch.bytes.resize((batchBytes > 2 * carry.size()) ? batchBytes : 2 * carry.size());
+        }
+        batch.length = carry.size();
+        if (!carry.empty()) {
+            memcpy(batch.bytes.data(), carry.data(), carry.size());
+        }
+
+        bool failed = false;
+        bool end = false;
+        bool cut = false;
+        for (;;) {
+            if (batch.length == batch.bytes.size()) {
+                // The batch holds no newline, so it is one line longer than the batch.
+                if (batch.length >= maxLineBytes) {
+                    batch.length = maxLineBytes;
+                    cut = true;
+                    break;
+                }
+                size_t grown = 2 * batch.bytes.size();
+                batch.bytes.resize((grown < maxLineBytes) ? grown : maxLineBytes);
+            }
+            char* start = batch.bytes.data() + batch.length;
+            ssize_t received = read(inputFd, start, batch.bytes.size() - batch.length);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                failed = received < 0;
+                end = true;
+                break;
+            }
+            if (skipping) {
+                // Drop the bytes up to the end of the cut line.
+                char* newline = (char*)memchr(start, '\n', (size_t)received);
+                if (newline == nullptr) {
+                    continue;
+                }
+                skipping = false;
+                received -= newline + 1 - start;
+                memmove(start, newline + 1, (size_t)received);
+            }
+            batch.length += (size_t)received;
+            if (memchr(start, '\n', (size_t)received) != nullptr) {
+                break;            // At least one more line is complete
+            }
+        }
+
+        carry.clear();
+        if (cut) {
+            skipping = true;      // The cut line is handed on as it is
+            truncated++;
+        } else if (!end) {
+            // Keep the whole lines; the rest starts the next batch.
+            const char* lastNewline = (const char*)memrchr(batch.bytes.data(), '\n', batch.length);
+            size_t whole = (size_t)(lastNewline - batch.bytes.data()) + 1;
+            carry.assign(batch.bytes.data() + whole, batch.bytes.data() + batch.length);
+            batch.length = whole;
+        }
+        batch.last = end;
+        if (failed) {
+            std::lock_guard<std::mutex> lock(mutex);
+            readFailed = true;
+        }
+        queueFull(index);
+        if (end) {
+            return;
+        }
+    }
+}
+
+// Scoring stage, on the calling thread, between the reader thread and the writer thread.
+bool StreamClassifier::run(int inputFd, int outputFd) {
+    fullHead = 0;
+    fullCount = 0;
+    freeCount = 0;
+    for (size_t i = 0; i < BATCH_COUNT; i++) {
+        freeIndex[freeCount++] = i;
+    }
+    readFailed = false;
+    lines = 0;
+    classified = 0;
+    truncated = 0;
+
+    AsyncFileWriter out;
+    out.attach(outputFd);
+    std::thread reader(&StreamClassifier::readerLoop, this, inputFd);
+
+    CsvRecord fields;             // Reused for the CSV fields of every line
+    bool last = false;
+    while (!last) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (fullCount == 0) {
+                // Nothing more to score yet: hand the results so far to the writer rather
+                // than holding them back until the buffer fills.
+                lock.unlock();
+                out.submitPartial();
+                lock.lock();
+            }
+            batchFilled.wait(lock, [this] { return fullCount > 0; });
+            index = fullIndex[fullHead];
+            fullHead = (fullHead + 1) % BATCH_COUNT;
+            fullCount--;
+        }
+        const Batch& batch = batches[index];
+        DSStringView contents(batch.bytes.data(), batch.length);
+        size_t offset = 0;
+        DSStringView line;
+        while (FileIO::nextLine(contents, offset, line)) {
+            lines++;
+            DSStringView text;
+            DSStringView id;
+            if (format == INPUT_CSV) {
+                // Expected format: tweetID, date, query, username, tweet_text (as in the test file).
+                fields.parse(line);
+                if (fields.size() < 5) {
+                    continue;
+                }
+                id = fields[0];
+                text = fields[4];
+            } else {
+                if (line.empty()) {
+                    continue;
+                }
+                text = line;
+            }
+            double score = classifier.score(text);
+            out.writeInt((score >= 0.0) ? 4 : 0);   // The same rule as predict
+            out.put(',');
+            if (format == INPUT_CSV) {
+                out.write(id);
+            } else {
+                out.writeInt((long long)lines);     // Plain text: the line number is the ID
+            }
+            if (withScores) {
+                out.put(',');
+                writeScore(out, score);
+            }
+            out.put('\n');
+            classified++;
+        }
+        last = batch.last;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeIndex[freeCount++] = index;
+        }
+        batchFreed.notify_one();
+    }
+    reader.join();
+
+    bool written = out.close();
+    if (truncated > 0) {
+        std::cerr << "Warning: " << truncated << " input line(s) longer than " << maxLineBytes
+                  << " bytes were cut to that length before classifying." << std::endl;
+    }
+    if (readFailed) {
+        std::cerr << "Error: Unable to read the input stream." << std::endl;
+    }
+    if (!written) {
+        std::cerr << "Error: Unable to write the output stream." << std::endl;
+    }
+    return !readFailed && written;
+}
@@ -0,0 +1,87 @@
+#ifndef STREAMCLASSIFIER_H
+#define STREAMCLASSIFIER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "SentimentClassifier.h"
+
+// Classifies a stream of tweets from one descriptor to another, for shell pipelines
+// (`sentiment classify`). Each input line is a tweet, either a CSV record in the
+// layout of the test file (id, date, query, user, text; lines with fewer fields are
+// skipped) or plain text (the tweet's ID is then its line number, and empty lines are
+// skipped). Every tweet becomes one output line, "label,id" or "label,id,score", in
+// input order.
+//
+// Reading, scoring and writing overlap in a three-stage pipeline. A reader thread fills
+// line-aligned batches from the input; the calling thread scores them; an
+// AsyncFileWriter writes the output on its own thread. Whenever the scorer runs out of
+// input it hands what it has written so far to the writer, so an interactive producer
+// sees each result without waiting for a full output buffer. Memory is bounded by
+// BATCH_COUNT input batches plus the writer's buffers, however long the stream is: a
+// batch only grows if a single line is longer than it, and never past maxLineBytes
+// (at least batchBytes). A longer line is cut to its first maxLineBytes bytes, with a warning on stderr.
+class StreamClassifier {
+public:
+    enum InputFormat {
+        INPUT_CSV,
+        INPUT_TEXT
+    };
+
+    static const size_t DEFAULT_BATCH_BYTES = 1 << 20; // 1 MiB
+    static const size_t DEFAULT_MAX_LINE_BYTES = 1 << 24; // 16 MiB
+private:
+    static const size_t BATCH_COUNT = 4;
+
+    // A run of whole input lines.
+    struct Batch {
+        std::vector<char> bytes;  // bytes[0 .. length) holds the lines
+        size_t length;
+        bool last;                // the end of the input follows this batch
+    };
+
+    const SentimentClassifier& classifier;
+    InputFormat format;
+    bool withScores;
+    size_t batchBytes;
+    size_t maxLineBytes;
+    Batch batches[BATCH_COUNT];
+
+    // Hand-off between the reader thread and the scorer, guarded by 'mutex'.
+    size_t fullIndex[BATCH_COUNT];   // filled batches, oldest first
+    size_t fullHead;
+    size_t fullCount;
+    size_t freeIndex[BATCH_COUNT];   // batches the reader may fill
+    size_t freeCount;
+    bool readFailed;
+    std::mutex mutex;
+    std::condition_variable batchFilled;
+    std::condition_variable batchFreed;
+
+    unsigned long long lines;
+    unsigned long long classified;
+    unsigned long long truncated;  // lines cut to maxLineBytes (written by the reader thread)
+
+    void readerLoop(int inputFd);
+    void queueFull(size_t index);
+
+    // Not copyable.
+    StreamClassifier(const StreamClassifier&);
+    StreamClassifier& operator=(const StreamClassifier&);
+public:
+    StreamClassifier(const SentimentClassifier& classifier, InputFormat format, bool withScores,
+                     size_t batchBytes = DEFAULT_BATCH_BYTES, size_t maxLineBytes = DEFAULT_MAX_LINE_BYTES);
+
+    // Classifies everything readable from inputFd until its end and writes the results
+    // to outputFd. Neither descriptor is closed. Returns false, after printing an error,
+    // if reading or writing fails.
+    bool run(int inputFd, int outputFd);
+
+    // Input lines read and tweets classified by the last run.
+    unsigned long long lineCount() const { return lines; }
+    unsigned long long classifiedCount() const { return classified; }
+    unsigned long long truncatedCount() const { return truncated; }
+};
+
+#endif // STREAMCLASSIFIER_H
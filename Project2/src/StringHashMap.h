@@ -0,0 +1,89 @@
+#ifndef STRINGHASHMAP_H
+#define STRINGHASHMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DSStringView.h"
+#include "StringInterner.h"
+
+// Open-addressing hash map from strings to values of type V: a StringInterner for the
+// keys plus one flat array of values indexed by the interned ID.
+//
+// Layout (all flat arrays, no per-entry allocation):
+//  - the interner's key pool, offsets and probe table (see StringInterner.h);
+//  - values: value i belongs to key i. Entries stay in insertion order, so an
+//    entry's index is a stable, dense ID and iteration is a plain loop.
+// Entries cannot be erased. Key bytes are limited to 4 GiB in total.
+template <typename V>
+class StringHashMap {
+private:
+    StringInterner keys;
+    std::vector<V> values;
+public:
+    static const size_t NOT_FOUND = StringHashIndex::NOT_FOUND;
+
+    static uint32_t hash(const char* key, size_t length) {
+        return StringHashIndex::hash(key, length);
+    }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    // Key and value of entry i (0 <= i < size(), in insertion order).
+    DSStringView keyAt(size_t i) const {
+        return keys.keyAt(i);
+    }
+    V& valueAt(size_t i) { return values[i]; }
+    const V& valueAt(size_t i) const { return values[i]; }
+
+    // Index of the entry for 'key', or NOT_FOUND. Never modifies the map.
+    size_t indexOf(const DSStringView& key) const {
+        return keys.find(key);
+    }
+
+    // Read-only view of the lookup arrays; invalidated by the next insert, reserve or clear.
+    StringHashIndex index() const {
+        return keys.index();
+    }
+
+    // The values as one contiguous array, in entry order.
+    const V* valueData() const { return values.data(); }
+
+    // Pointer to the value for 'key', or nullptr. Never modifies the map.
+    V* find(const DSStringView& key) {
+        size_t i = indexOf(key);
+        return (i == NOT_FOUND) ? nullptr : &values[i];
+    }
+    const V* find(const DSStringView& key) const {
+        size_t i = indexOf(key);
+        return (i == NOT_FOUND) ? nullptr : &values[i];
+    }
+
+    // Index of the entry for 'key', inserting it with a value-initialized V if missing.
+    size_t insert(const DSStringView& key) {
+        uint32_t entry = keys.intern(key);
+        if (entry == values.size()) {
+            values.push_back(V());   // A new key gets the next ID, i.e. the next value slot
+        }
+        return entry;
+    }
+
+    // Like std::map::operator[]: the value for 'key', inserted if missing.
+    V& operator[](const DSStringView& key) {
+        return values[insert(key)];
+    }
+
+    // Make room for n entries (and about 'keyBytes' bytes of keys) without further growth.
+    void reserve(size_t n, size_t keyBytes = 0) {
+        keys.reserve(n, keyBytes);
+        values.reserve(n);
+    }
+
+    void clear() {
+        keys.clear();
+        values.clear();
+    }
+};
+
+#endif // STRINGHASHMAP_H
@@ -0,0 +1,79 @@
+#include "StringInterner.h"    // Include the header file for the StringInterner class
+
+// Constructor: no strings yet, so the offsets hold just the end of the (empty) pool
+StringInterner::StringInterner() {
+    keyOffsets.push_back(0);
+}
+
+// Rebuild the probe table from the hashes stored in the old slots (no key is rehashed)
+void StringInterner::rehash(size_t capacity) {
+    rehashSlots(slots, capacity);
+}
+
+// Move every entry of a probe table into a new one of 'capacity' slots, in slot order
+void StringInterner::rehashSlots(std::vector<StringHashSlot>& slots, size_t capacity) {
+    std::vector<StringHashSlot> old;
+    old.swap(slots);
+    StringHashSlot empty = { 0, StringHashIndex::EMPTY };
+    slots.assign(capacity, empty);
+    size_t mask = capacity - 1;
+    for (size_t j = 0; j < old.size(); j++) {
+        if (old[j].index == StringHashIndex::EMPTY) {
+            continue;
+        }
+        size_t i = old[j].hash & mask;
+        while (slots[i].index != StringHashIndex::EMPTY) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = old[j];
+    }
+}
+
+// Look the key up, appending its bytes to the pool under the next ID if it is new
+uint32_t StringInterner::intern(const DSStringView& key) {
+    if (needsGrowth(size(), slots.size())) {
+        rehash(growCapacity(slots.size()));
+    }
+    uint32_t h = StringHashIndex::hash(key.data(), key.length());
+    size_t i = index().probe(key.data(), key.length(), h);
+    if (slots[i].index != StringHashIndex::EMPTY) {
+        return slots[i].index;    // Seen before: its existing ID
+    }
+    uint32_t id = (uint32_t)size();
+    keyPool.insert(keyPool.end(), key.data(), key.data() + key.length());
+    keyOffsets.push_back((uint32_t)keyPool.size());
+    slots[i].hash = h;
+    slots[i].index = id;
+    return id;
+}
+
+// Point a lookup view at the current arrays
+StringHashIndex StringInterner::index() const {
+    StringHashIndex view;
+    view.slots = slots.data();
+    view.slotCount = slots.size();
+    view.keyOffsets = keyOffsets.data();
+    view.keyPool = keyPool.data();
+    view.size = size();
+    return view;
+}
+
+// Grow the probe table and the key arrays once, up front
+void StringInterner::reserve(size_t n, size_t keyBytes) {
+    size_t capacity = slots.empty() ? 16 : slots.size();
+    while (n * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+    if (capacity != slots.size()) {
+        rehash(capacity);
+    }
+    keyOffsets.reserve(n + 1);
+    keyPool.reserve(keyBytes);
+}
+
+// Forget every string (IDs start again at 0)
+void StringInterner::clear() {
+    slots.clear();
+    keyOffsets.assign(1, 0);
+    keyPool.clear();
+}
@@ -0,0 +1,137 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "DSStringView.h"
+
+// One probe-table slot: the key's precomputed hash and its entry index.
+struct StringHashSlot {
+    uint32_t hash;   // hash of the key stored in this slot
+    uint32_t index;  // entry index, or StringHashIndex::EMPTY
+};
+
+// Read-only, non-owning view of a StringInterner's lookup arrays (probe table and keys).
+// It answers indexOf() without touching the map object itself, and the same arrays can
+// live in any memory, e.g. a memory-mapped model file (see SentimentClassifier::load).
+struct StringHashIndex {
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+    static const size_t NOT_FOUND = (size_t)-1;
+
+    const StringHashSlot* slots;  // slotCount slots, slotCount a power of two (or 0)
+    size_t slotCount;
+    const uint32_t* keyOffsets;   // size + 1 offsets into keyPool
+    const char* keyPool;
+    size_t size;                  // number of entries
+
+    StringHashIndex() : slots(nullptr), slotCount(0), keyOffsets(nullptr), keyPool(nullptr), size(0) {}
+
+    // Hash of a run of bytes (DSStringView::hash, so keys hash the same everywhere).
+    static uint32_t hash(const char* key, size_t length) {
+        return DSStringView(key, length).hash();
+    }
+
+    // Probe for 'key'; returns the slot holding it, or the empty slot where it would go.
+    // Requires slotCount > 0.
+    size_t probe(const char* key, size_t length, uint32_t h) const {
+        size_t mask = slotCount - 1;
+        size_t i = h & mask;
+        while (true) {
+            const StringHashSlot& slot = slots[i];
+            if (slot.index == EMPTY) {
+                return i;
+            }
+            if (slot.hash == h) {
+                uint32_t start = keyOffsets[slot.index];
+                uint32_t stop = keyOffsets[slot.index + 1];
+                if (stop - start == length && memcmp(keyPool + start, key, length) == 0) {
+                    return i;
+                }
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    // Index of the entry for 'key', or NOT_FOUND.
+    size_t indexOf(const DSStringView& key) const {
+        if (size == 0) {
+            return NOT_FOUND;
+        }
+        const StringHashSlot& slot = slots[probe(key.data(), key.length(), hash(key.data(), key.length()))];
+        return (slot.index == EMPTY) ? NOT_FOUND : slot.index;
+    }
+
+    // Key of entry i.
+    DSStringView keyAt(size_t i) const {
+        return DSStringView(keyPool + keyOffsets[i], keyOffsets[i + 1] - keyOffsets[i]);
+    }
+};
+
+// Interning dictionary: gives every distinct string a dense 32-bit ID (0, 1, 2, ... in
+// first-seen order) and stores its bytes exactly once. Tables about the strings can
+// then be plain arrays indexed by ID, and a string is compared by content only when
+// it is looked up, never again afterwards.
+//
+// Layout (all flat arrays, no per-string allocation):
+//  - keyPool / keyOffsets: every key's bytes stored back to back; key i is
+//    keyPool[keyOffsets[i] .. keyOffsets[i + 1]).
+//  - slots: the probe table (power-of-two size, linear probing). Each slot holds
+//    the precomputed 32-bit hash and the ID, so a probe compares the hash first and
+//    only touches the key bytes on a hash match, and growing the table never
+//    rehashes a key.
+// Strings cannot be removed. Key bytes are limited to 4 GiB in total.
+class StringInterner {
+private:
+    std::vector<StringHashSlot> slots;
+    std::vector<uint32_t> keyOffsets;  // size() + 1 offsets into keyPool
+    std::vector<char> keyPool;
+
+    // Rebuild the probe table with 'capacity' slots (a power of two) from the stored hashes.
+    void rehash(size_t capacity);
+public:
+    static const size_t NOT_FOUND = StringHashIndex::NOT_FOUND;
+
+    // The probe table policy, for tables kept outside an interner that must come out
+    // slot for slot the same as an interner's given the same keys in the same order
+    // (see SentimentClassifier::update). Before looking up or adding a key, a table of
+    // 'slotCount' slots holding 'size' keys is rebuilt with growCapacity() slots if
+    // needsGrowth() says so.
+    static bool needsGrowth(size_t size, size_t slotCount) {
+        return (size + 1) * 10 > slotCount * 7;   // Keep the load factor at or below 7/10
+    }
+    static size_t growCapacity(size_t slotCount) {
+        return (slotCount == 0) ? 16 : slotCount * 2;
+    }
+    static void rehashSlots(std::vector<StringHashSlot>& slots, size_t capacity);
+
+    StringInterner();
+
+    // Number of interned strings; the IDs in use are 0 .. size() - 1.
+    size_t size() const { return keyOffsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    // ID of 'key', assigning the next ID (size()) if it has not been seen before.
+    uint32_t intern(const DSStringView& key);
+
+    // ID of 'key', or NOT_FOUND. Never modifies the dictionary.
+    size_t find(const DSStringView& key) const {
+        return index().indexOf(key);
+    }
+
+    // The string with ID 'id'.
+    DSStringView keyAt(size_t id) const {
+        return DSStringView(keyPool.data() + keyOffsets[id], keyOffsets[id + 1] - keyOffsets[id]);
+    }
+
+    // Read-only view of the lookup arrays; invalidated by the next intern, reserve or clear.
+    StringHashIndex index() const;
+
+    // Make room for n strings (and about 'keyBytes' bytes of keys) without further growth.
+    void reserve(size_t n, size_t keyBytes = 0);
+
+    void clear();
+};
+
+#endif // STRINGINTERNER_H
@@ -0,0 +1,65 @@
+#include "SuffixStemmer.h"  // Include the header file for the SuffixStemmer class
+#include <cstring>          // Include cstring for strlen() and memset()
+#include <iostream>         // Include iostream for errors about rules that cannot be used
+
+const SuffixRule SuffixStemmer::SIMPLE_RULES[] = {
+    { "ing", 3, 5 },                // "walking" -> "walk", but "sing" stays
+    { "ed", 2, 4 },                 // "jumped" -> "jump", but "bed" stays
+    { "s", 1, 4 },                  // "cats" -> "cat", but "is" and "was" stay
+};
+const size_t SuffixStemmer::SIMPLE_RULE_COUNT = sizeof(SIMPLE_RULES) / sizeof(SIMPLE_RULES[0]);
+
+// Nodes and rules are numbered with 16 bits: node 65535 is the last one, and rule
+// 65535 is NO_RULE, so at most 65535 rules can be used.
+static const size_t MAX_NODES = 0x10000;
+
+// Give every byte used in a suffix its own column, then insert each suffix backwards
+// into the trie, recording the rule at the node where it ends. Rules that do not fit
+// the 16-bit numbering, and rules with an empty suffix, are reported and ignored.
+SuffixStemmer::SuffixStemmer(const SuffixRule* ruleList, size_t count)
+    : width(1), rules(ruleList, ruleList + count) {
+    if (count > NO_RULE) {
+        std::cerr << "Error: " << count << " stemming rules given; only the first " << NO_RULE
+                  << " are used." << std::endl;
+        count = NO_RULE;
+        rules.resize(count);
+    }
+    memset(symbols, 0, sizeof(symbols));
+    for (size_t r = 0; r < count; r++) {
+        for (const char* c = rules[r].suffix; *c != '\0'; c++) {
+            if (symbols[(unsigned char)*c] == 0) {
+                symbols[(unsigned char)*c] = (uint8_t)width++;
+            }
+        }
+    }
+    next.assign(2 * width, 0);      // Node 0 is the dead end, node 1 the root
+    ruleAt.assign(2, (uint16_t)NO_RULE);
+    for (size_t r = 0; r < count; r++) {
+        size_t length = strlen(rules[r].suffix);
+        if (length == 0) {
+            std::cerr << "Error: stemming rule " << r << " has an empty suffix and is ignored." << std::endl;
+            continue;                  // The root is never checked for a rule
+        }
+        if (rules[r].remove > length) {
+            rules[r].remove = length;
+        }
+        size_t node = 1;
+        for (size_t i = length; i > 0; i--) {
+            size_t cell = node * width + symbols[(unsigned char)rules[r].suffix[i - 1]];
+            if (next[cell] == 0) {
+                if (ruleAt.size() == MAX_NODES) {
+                    std::cerr << "Error: the stemming rules need more than " << MAX_NODES
+                              << " trie nodes; rule " << r << " and the rules after it are ignored." << std::endl;
+                    return;
+                }
+                next[cell] = (uint16_t)ruleAt.size();  // Append a new node
+                next.resize(next.size() + width, 0);
+                ruleAt.push_back((uint16_t)NO_RULE);
+            }
+            node = next[cell];
+        }
+        if (ruleAt[node] == NO_RULE) {
+            ruleAt[node] = (uint16_t)r;                // The first rule listed for a suffix wins
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SUFFIXSTEMMER_H
+#define SUFFIXSTEMMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DSStringView.h"
+
+// One suffix-stripping rule: a word of at least minWordLength bytes that ends with
+// 'suffix' loses its last 'remove' bytes. 'remove' may be shorter than the suffix (e.g.
+// "sses" -> remove 2 gives "ss") or zero, which keeps words with that ending away from
+// the rules for shorter suffixes (e.g. "ss" -> remove 0 protects "class" from "s").
+struct SuffixRule {
+    const char* suffix;
+    size_t remove;
+    size_t minWordLength;
+};
+
+// Table-driven suffix stripper for lowercase words. The rules are compiled into a trie
+// of reversed suffixes, walked from the last byte of the word backwards, so finding the
+// rule costs one table step per matched byte whatever the number of rules. Of the rules
+// whose suffix ends the word and whose length condition holds, the one with the longest
+// suffix applies (the first listed on a tie). Stemming only shortens the word, so it
+// works on views in place and never allocates; the stemmer is read-only after
+// construction and can be shared between threads.
+class SuffixStemmer {
+private:
+    static const uint16_t NO_RULE = 0xFFFF;
+
+    uint8_t symbols[256];              // byte -> column of the transition table (0: in no suffix)
+    size_t width;                      // columns per node
+    std::vector<uint16_t> next;        // node * width + column -> child node (0: none)
+    std::vector<uint16_t> ruleAt;      // node -> index into 'rules' of the suffix ending there, or NO_RULE
+    std::vector<SuffixRule> rules;
+public:
+    // Builds the stemmer from 'count' rules (copied; the suffix strings must outlive it).
+    // A rule never removes more than its suffix. Rules with an empty suffix, rules past
+    // the 65535th, and rules that would need more than 65536 trie nodes are reported on
+    // stderr and ignored.
+    SuffixStemmer(const SuffixRule* ruleList, size_t count);
+
+    // Length of the stem of the lowercase word: its length minus what the matching rule removes.
+    size_t stemLength(const char* word, size_t length) const {
+        size_t stem = length;
+        uint16_t node = 1;             // The root
+        for (size_t i = length; i > 0; i--) {
+            node = next[node * width + symbols[(unsigned char)word[i - 1]]];
+            if (node == 0) {
+                break;                 // No rule has this ending
+            }
+            uint16_t rule = ruleAt[node];
+            if (rule != NO_RULE && length >= rules[rule].minWordLength) {
+                stem = length - rules[rule].remove;  // Deeper nodes are longer suffixes: later matches win
+            }
+        }
+        return stem;
+    }
+
+    // Shrinks the view of a lowercase word to its stem.
+    void stemInPlace(DSStringView& word) const {
+        word = DSStringView(word.data(), stemLength(word.data(), word.length()));
+    }
+
+    // The simple stemmer's rules: "ing" (words longer than 4), "ed" (longer than 3)
+    // and trailing "s" (longer than 3).
+    static const SuffixRule SIMPLE_RULES[];
+    static const size_t SIMPLE_RULE_COUNT;
+};
+
+#endif // SUFFIXSTEMMER_H
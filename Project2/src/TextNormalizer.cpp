@@ -0,0 +1,117 @@
+#include "TextNormalizer.h"     // Include the header file for the TextNormalizer class
+#include "TextProcessor.h"      // Include TextProcessor for the default stop-word list and stemming rules
+#include "ByteScanner.h"        // Include ByteScanner for the vectorized lowercasing and byte classification
+#include <cstring>              // Include cstring for memcpy() and memset()
+
+// Bytes moved per step when copying a run of kept bytes (one unaligned vector load/store).
+static const size_t COPY_STEP = 16;
+
+// What normalization makes of each byte of a word: its lowercase form if it is kept
+// (an ASCII letter or digit, or whitespace other than ' ', as in ByteScanner), else 0.
+struct WordByteTable {
+    char map[256];
+
+    WordByteTable() {
+        for (int c = 0; c < 256; c++) {
+            bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            bool whitespace = c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+            map[c] = (alnum || whitespace) ? (char)((c >= 'A' && c <= 'Z') ? c | 0x20 : c) : 0;
+        }
+    }
+};
+static const WordByteTable wordBytes;
+
+// Normalize with the pipeline's own stop words and stemming rules.
+TextNormalizer::TextNormalizer() : stopWords(TextProcessor::stopWords()), stemmer(TextProcessor::stemmer()) {
+}
+
+// Normalize with the given stop words and stemming rules.
+TextNormalizer::TextNormalizer(const StopWordSet& stopWords, const SuffixStemmer& stemmer)
+    : stopWords(stopWords), stemmer(stemmer) {
+}
+
+// Record the token at 'token' unless it is empty or a stop word; stem it in place.
+void TextNormalizer::finishToken(const char* token, size_t length) {
+    if (length == 0) {
+        return;                   // Consecutive spaces produce empty tokens; the pipeline drops them.
+    }
+    if (stopWords.contains(DSStringView(token, length))) {
+        return;
+    }
+    tokens.push_back(DSStringView(token, stemmer.stemLength(token, length)));
+}
+
+// Normalize a single word: map every byte through the table, then finish it as a token.
+bool TextNormalizer::normalizeWord(const DSStringView& word, DSStringView& token) {
+    tokens.clear();
+    arena.reset();
+    char* out = arena.allocate(word.length());
+    size_t written = 0;
+    for (size_t i = 0; i < word.length(); i++) {
+        char c = wordBytes.map[(unsigned char)word[i]];
+        out[written] = c;
+        written += (c != 0);      // Dropped bytes are overwritten by the next kept one
+    }
+    finishToken(out, written);
+    if (tokens.empty()) {
+        return false;
+    }
+    token = tokens[0];
+    return true;
+}
+
+// Normalize one tweet: vectorized passes lowercase it and classify every byte, then a
+// walk over the class masks copies whole runs of kept bytes at a time.
+const std::vector<DSStringView>& TextNormalizer::normalize(const DSStringView& text) {
+    tokens.clear();
+    // The previous tweet's tokens are dead: release them and take this tweet's scratch
+    // space from the arena. The lowercase copy is zero-padded to whole 64-byte blocks
+    // (plus one 16-byte copy step), so the kernels only ever see full blocks and the run
+    // copies below may read past a run's end; zero bytes are dropped like punctuation.
+    arena.reset();
+    size_t length = text.length();
+    size_t words = ByteScanner::maskWords(length);
+    size_t padded = words * 64;
+    uint64_t* alnum = (uint64_t*)arena.allocate(3 * words * sizeof(uint64_t), sizeof(uint64_t));
+    uint64_t* space = alnum + words;  // Whitespace, including ' '
+    uint64_t* blank = space + words;  // ' ' only: the token delimiter
+    char* lowered = arena.allocate(padded + COPY_STEP);
+    char* out = arena.allocate(length + COPY_STEP);  // The output is never longer than the input
+    ByteScanner::toLower(text.data(), lowered, length);
+    memset(lowered + length, 0, padded + COPY_STEP - length);
+    ByteScanner::classify(lowered, padded, alnum, space);
+    ByteScanner::match(lowered, padded, ' ', blank);
+
+    size_t written = 0;           // Bytes of output so far
+    size_t tokenStart = 0;        // Where the current token begins in out
+    for (size_t w = 0; w < words; w++) {
+        size_t base = w * 64;
+        // Letters, digits and whitespace other than ' ' are kept; ' ' splits; the rest is dropped.
+        uint64_t keep = alnum[w] | (space[w] & ~blank[w]);
+        uint64_t split = blank[w];
+        size_t i = 0;
+        while (i < 64) {
+            uint64_t rest = keep >> i;
+            if (rest & 1) {
+                // A run of kept bytes: append it COPY_STEP bytes at a time. Bytes copied past
+                // the run's end are overwritten by the next run or lie past the last token.
+                size_t run = (~rest == 0) ? 64 - i : (size_t)__builtin_ctzll(~rest);
+                for (size_t k = 0; k < run; k += COPY_STEP) {
+                    memcpy(out + written + k, lowered + base + i + k, COPY_STEP);
+                }
+                written += run;
+                i += run;
+            } else if ((split >> i) & 1) {
+                finishToken(out + tokenStart, written - tokenStart);
+                tokenStart = written;
+                i++;
+            } else {
+                // A run of dropped bytes: skip to the next kept or splitting byte.
+                uint64_t next = (keep | split) >> i;
+                i = (next == 0) ? 64 : i + (size_t)__builtin_ctzll(next);
+            }
+        }
+    }
+    finishToken(out + tokenStart, written - tokenStart);  // The last token (the pipeline always emits one)
+    return tokens;
+}
@@ -0,0 +1,46 @@
+#ifndef TEXTNORMALIZER_H
+#define TEXTNORMALIZER_H
+
+#include <vector>
+#include "Arena.h"
+#include "DSStringView.h"
+#include "StopWordSet.h"
+#include "SuffixStemmer.h"
+
+// Single-pass tweet normalizer.
+// Produces exactly the tokens of the chained TextProcessor pipeline
+//   toLower -> removePunctuation -> Tokenizer::tokenize(' ') -> removeStopWords -> stem
+// but in one pass over the tweet bytes: ByteScanner lowercases the tweet and classifies
+// every byte into bit masks (SSE2/AVX2 where available), runs of kept bytes are then
+// copied whole and cut into tokens at spaces, and the stop-word test and suffix
+// stripping run on the finished token in place. Tokens are written into an arena that
+// is reset at the start of every call, so steady-state normalization allocates nothing.
+// Like the pipeline (which runs in the "C" locale), only ASCII letters and digits are
+// alphanumeric; bytes >= 0x80 are dropped as punctuation.
+class TextNormalizer {
+private:
+    Arena arena;                       // bytes of all tokens of the current tweet
+    std::vector<DSStringView> tokens;  // views into the arena
+    const StopWordSet& stopWords;      // not owned
+    const SuffixStemmer& stemmer;      // not owned
+
+    // Finishes the token of 'length' bytes at 'token': drops it if empty or a stop word,
+    // otherwise strips its suffix and records it.
+    void finishToken(const char* token, size_t length);
+public:
+    // Uses the stop words and stemmer of TextProcessor, so the tokens match its pipeline.
+    TextNormalizer();
+
+    // Uses other stop words and suffix rules; both must outlive the normalizer.
+    TextNormalizer(const StopWordSet& stopWords, const SuffixStemmer& stemmer);
+
+    // Normalizes 'text' and returns its tokens. The views stay valid until the next call.
+    const std::vector<DSStringView>& normalize(const DSStringView& text);
+
+    // Normalizes one word (text without ' ', which normalizes to at most one token) with
+    // a scalar loop that is cheaper than normalize() for such short inputs. Returns false
+    // if the word normalizes to nothing, otherwise sets 'token', valid until the next call.
+    bool normalizeWord(const DSStringView& word, DSStringView& token);
+};
+
+#endif // TEXTNORMALIZER_H
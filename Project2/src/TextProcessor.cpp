@@ -1,13 +1,45 @@
 #include "TextProcessor.h"        // Include the header file for the TextProcessor class
-#include <cctype>                 // Include cctype for character classification and conversion functions (e.g., std::tolower, std::isalnum, std::isspace)
+#include "ByteScanner.h"          // Include ByteScanner for the vectorized lowercasing and character classification
+#include "StopWordSet.h"          // Include StopWordSet for the constant-time stop-word lookup
+#include "SuffixStemmer.h"        // Include SuffixStemmer for the table-driven suffix stripping
+#include <cstdlib>                // Include cstdlib for std::exit() if the stop words cannot be hashed
+#include <iostream>               // Include iostream for that error message
+
+// Bytes handled per ByteScanner call by the helpers below, so their masks fit on the stack.
+static const size_t SCAN_CHUNK = 1024;
+
+// Copy the alphanumerics and whitespace of in[0 .. length) to out, in order, and return
+// how many were kept. The character classes match std::isalnum / std::isspace in the
+// "C" locale, and are computed for 64 bytes at a time.
+static size_t keepAlnumAndSpace(const char* in, size_t length, char* out) {
+    uint64_t alnum[SCAN_CHUNK / 64];
+    uint64_t space[SCAN_CHUNK / 64];
+    size_t kept = 0;
+    for (size_t start = 0; start < length; start += SCAN_CHUNK) {
+        size_t chunk = (length - start < SCAN_CHUNK) ? length - start : SCAN_CHUNK;
+        ByteScanner::classify(in + start, chunk, alnum, space);
+        for (size_t w = 0; w < ByteScanner::maskWords(chunk); w++) {
+            uint64_t keep = alnum[w] | space[w];
+            const char* base = in + start + w * 64;
+            while (keep != 0) {   // Visit the set bits, lowest first
+                out[kept++] = base[__builtin_ctzll(keep)];
+                keep &= keep - 1;
+            }
+        }
+    }
+    return kept;
+}
 
 // Convert the input DSString to all lowercase letters.
 DSString TextProcessor::toLower(const DSString& input) {
     DSString result;              // Create an empty DSString to store the lowercase result
+    result.reserve(input.length()); // The result has exactly the input's length: allocate once
     const char* data = input.c_str(); // Get the C-string representation of the input DSString
-    for (size_t i = 0; i < input.length(); i++) { // Loop through each character in the input DSString
-        // Append the lowercase version of the current character to the result DSString
-        result.append(std::tolower(data[i]));  
+    char lowered[SCAN_CHUNK];     // Lowercase a chunk at a time, then append it
+    for (size_t start = 0; start < input.length(); start += SCAN_CHUNK) {
+        size_t chunk = (input.length() - start < SCAN_CHUNK) ? input.length() - start : SCAN_CHUNK;
+        ByteScanner::toLower(data + start, lowered, chunk);
+        result.append(lowered, chunk);
     }
     return result;                // Return the resulting DSString that is now all lowercase
 }
@@ -15,84 +47,114 @@ DSString TextProcessor::toLower(const DSString& input) {
 // Remove punctuation characters from the DSString (keeping only alphanumerics and spaces).
 DSString TextProcessor::removePunctuation(const DSString& input) {
     DSString result;              // Create an empty DSString to store the result without punctuation
+    result.reserve(input.length()); // The result is at most as long as the input: allocate once
     const char* data = input.c_str(); // Get the C-string representation of the input DSString
-    for (size_t i = 0; i < input.length(); i++) { // Loop through each character in the input
-        char c = data[i];         // Get the current character
-        // If the character is alphanumeric or a whitespace, then append it to the result
-        if (std::isalnum(c) || std::isspace(c)) {
-            result.append(c);
-        }
+    char kept[SCAN_CHUNK];        // Filter a chunk at a time, then append what was kept
+    for (size_t start = 0; start < input.length(); start += SCAN_CHUNK) {
+        size_t chunk = (input.length() - start < SCAN_CHUNK) ? input.length() - start : SCAN_CHUNK;
+        result.append(kept, keepAlnumAndSpace(data + start, chunk, kept));
     }
     return result;                // Return the DSString that contains only alphanumeric characters and spaces
 }
 
+// Fixed list of common stop words that were effective (~72% accuracy version).
+// Configuring with -DSENTIMENT_STOP_WORDS=<file> compiles a different list in instead.
+static const char* const stopWordsArray[] = {
+#ifdef SENTIMENT_CUSTOM_STOP_WORDS
+#include "CustomStopWords.inc"    // Generated by CMake from the configured word file
+#else
+    "the", "and", "is", "in", "at", "of", "a", "an", "to"
+#endif
+};
+static const size_t stopWordsCount = sizeof(stopWordsArray) / sizeof(stopWordsArray[0]);
+
+// The list as a collision-free hash table, built once at startup, so a lookup costs the
+// same however many stop words there are.
+static const StopWordSet stopWordSet(stopWordsArray, stopWordsCount);
+
+// Every model depends on the stop words, so a list that cannot be hashed stops the
+// program at startup instead of quietly training and scoring with no stop words.
+static bool requireStopWords(const StopWordSet& set) {
+    if (!set.ok()) {
+        std::cerr << "Error: no hash seed places all " << set.size() << " stop words." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return true;
+}
+static const bool stopWordSetBuilt = requireStopWords(stopWordSet);  // Initialized right after the set
+
+// The stop words in use.
+const StopWordSet& TextProcessor::stopWords() {
+    return stopWordSet;
+}
+
+// Check a lowercase token against the stop word list.
+bool TextProcessor::isStopWord(const DSStringView& lowerToken) {
+    return stopWordSet.contains(lowerToken);
+}
+
+// Lowercase a view into the caller's arena (same per-character rule as toLower above).
+DSStringView TextProcessor::toLower(const DSStringView& input, Arena& arena) {
+    char* out = arena.allocate(input.length()); // Exactly one output character per input character
+    ByteScanner::toLower(input.data(), out, input.length());
+    return DSStringView(out, input.length());
+}
+
+// Keep only the alphanumerics and whitespace of a view, writing them into the caller's arena.
+DSStringView TextProcessor::removePunctuation(const DSStringView& input, Arena& arena) {
+    char* out = arena.allocate(input.length()); // The result is never longer than the input
+    return DSStringView(out, keepAlnumAndSpace(input.data(), input.length(), out));
+}
+
+// Filter stop words and empty tokens out of a list of views.
+void TextProcessor::removeStopWords(const std::vector<DSStringView>& tokens, std::vector<DSStringView>& filtered) {
+    filtered.clear();
+    for (size_t i = 0; i < tokens.size(); i++) {
+        if (tokens[i].length() > 0 && !stopWordSet.containsIgnoringCase(tokens[i])) {
+            filtered.push_back(tokens[i]);
+        }
+    }
+}
+
+// Stem of a lowercase token: the token minus the suffix the stemmer removes.
+DSStringView TextProcessor::stem(const DSStringView& lowerInput) {
+    return lowerInput.substr(0, stemLength(lowerInput.data(), lowerInput.length()));
+}
+
 // Remove common stop words from the list of tokens.
 std::vector<DSString> TextProcessor::removeStopWords(const std::vector<DSString>& tokens) {
-    // Define a fixed list of common stop words that were effective (~72% accuracy version).
-    const char* stopWordsArray[] = {"the", "and", "is", "in", "at", "of", "a", "an", "to"};
-    const int stopWordsCount = 9; // Total number of stop words in the array
-    
     std::vector<DSString> filtered;  // Create a vector to store tokens that are not stop words
     // Iterate through each token in the provided list.
     for (size_t i = 0; i < tokens.size(); i++) {
-        DSString lowerToken = toLower(tokens[i]); // Convert the token to lowercase for case-insensitive comparison
-        bool isStopWord = false;   // Flag to indicate if the current token is a stop word
-        // Check against each stop word in the list.
-        for (int j = 0; j < stopWordsCount; j++) {
-            DSString stopWord(stopWordsArray[j]); // Create a DSString for the current stop word
-            if (lowerToken == stopWord) { // Compare the lowercase token to the stop word
-                isStopWord = true;  // Mark as a stop word if they match
-                break;              // No need to check further stop words, so exit the loop
-            }
-        }
-        // If the token is not a stop word and is not empty, add it to the filtered vector.
-        if (!isStopWord && lowerToken.length() > 0) {
+        // If the token is not empty and not a stop word (compared case-insensitively), keep it.
+        if (tokens[i].length() > 0 && !stopWordSet.containsIgnoringCase(tokens[i])) {
             filtered.push_back(tokens[i]);
         }
     }
     return filtered;  // Return the vector of tokens with stop words removed
 }
 
+// The simple stemmer ("ing", "ed", and trailing "s") as a suffix trie.
+static const SuffixStemmer simpleStemmer(SuffixStemmer::SIMPLE_RULES, SuffixStemmer::SIMPLE_RULE_COUNT);
+
+// The stemmer in use.
+const SuffixStemmer& TextProcessor::stemmer() {
+    return simpleStemmer;
+}
+
+// Length of the stem of a lowercase word: the word minus the suffix the stemmer removes.
+size_t TextProcessor::stemLength(const char* word, size_t len) {
+    return simpleStemmer.stemLength(word, len);
+}
+
 // Simple stemming function: removes common suffixes ("ing", "ed", and trailing "s").
 DSString TextProcessor::stem(const DSString& input) {
     DSString lowerWord = toLower(input); // Convert the input token to lowercase
     size_t len = lowerWord.length();       // Get the length of the lowercase token
-    const char* word = lowerWord.c_str();    // Get the C-string representation of the lowercase token
-    
-    // If the word ends with "ing" and is long enough (length > 4 to ensure some stem remains)
-    if (len > 4 && word[len - 3] == 'i' && word[len - 2] == 'n' && word[len - 1] == 'g') {
-        char* buffer = new char[len - 3 + 1]; // Allocate memory for the stem (original length minus "ing" plus null terminator)
-        for (size_t i = 0; i < len - 3; i++) {  // Copy characters excluding the last three
-            buffer[i] = word[i];
-        }
-        buffer[len - 3] = '\0';    // Append the null terminator to the new string
-        DSString stemmed(buffer);  // Create a DSString from the stemmed C-string
-        delete[] buffer;           // Free the allocated memory
-        return stemmed;            // Return the stemmed token
-    }
-    // If the word ends with "ed" and is long enough (length > 3 to ensure some stem remains)
-    if (len > 3 && word[len - 2] == 'e' && word[len - 1] == 'd') {
-        char* buffer = new char[len - 2 + 1]; // Allocate memory for the stem (original length minus "ed" plus null terminator)
-        for (size_t i = 0; i < len - 2; i++) {  // Copy characters excluding the last two
-            buffer[i] = word[i];
-        }
-        buffer[len - 2] = '\0';    // Append the null terminator
-        DSString stemmed(buffer);  // Create a DSString from the stemmed C-string
-        delete[] buffer;           // Free the allocated memory
-        return stemmed;            // Return the stemmed token
-    }
-    // If the word ends with "s" (and is not very short, to avoid removing 's' from words that are only one letter)
-    if (len > 3 && word[len - 1] == 's') {
-        char* buffer = new char[len - 1 + 1]; // Allocate memory for the stem (original length minus 1 plus null terminator)
-        for (size_t i = 0; i < len - 1; i++) {  // Copy all characters except the last one
-            buffer[i] = word[i];
-        }
-        buffer[len - 1] = '\0';    // Append the null terminator
-        DSString stemmed(buffer);  // Create a DSString from the stemmed C-string
-        delete[] buffer;           // Free the allocated memory
-        return stemmed;            // Return the stemmed token
+    size_t stemmedLength = stemLength(lowerWord.c_str(), len); // Find where the stem ends
+    if (stemmedLength == len) {
+        // If no suffix applies, return the lowercase token unchanged.
+        return lowerWord;
     }
-    
-    // If none of the conditions above apply, return the lowercase token unchanged.
-    return lowerWord;
+    return DSString(lowerWord.c_str(), stemmedLength); // Copy out the stem
 }
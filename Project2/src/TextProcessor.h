@@ -2,7 +2,11 @@
 #define TEXTPROCESSOR_H
 
 #include <vector>
+#include "Arena.h"
 #include "DSString.h"
+#include "DSStringView.h"
+#include "StopWordSet.h"
+#include "SuffixStemmer.h"
 
 class TextProcessor {
 public:
@@ -18,6 +22,37 @@ public:
     // Reduces a token to its stem (a simple implementation).
     static DSString stem(const DSString& input);
 
+    // View-based overloads. They produce the same results as the DSString versions
+    // but never allocate per call: toLower and removePunctuation write into the
+    // caller's arena (reset by the caller between tweets) and return a view of it,
+    // while removeStopWords and stem only narrow views of their input.
+
+    // Lowercases 'input' into 'arena'; the view is valid until the arena is reset.
+    static DSStringView toLower(const DSStringView& input, Arena& arena);
+
+    // Copies the alphanumerics and whitespace of 'input' into 'arena'.
+    static DSStringView removePunctuation(const DSStringView& input, Arena& arena);
+
+    // Appends the tokens that are neither empty nor stop words (compared
+    // case-insensitively) to 'filtered', which is cleared first.
+    static void removeStopWords(const std::vector<DSStringView>& tokens, std::vector<DSStringView>& filtered);
+
+    // Stem of an already lowercase token, as a prefix of it.
+    static DSStringView stem(const DSStringView& lowerInput);
+
+    // True if the (already lowercase) token is one of the stop words.
+    static bool isStopWord(const DSStringView& lowerToken);
+
+    // The stop-word set behind isStopWord and removeStopWords.
+    static const StopWordSet& stopWords();
+
+    // Length of the stem of an already lowercase word: the word's length minus the
+    // suffix that stem() would remove. The stem is the first stemLength() characters.
+    static size_t stemLength(const char* lowerWord, size_t length);
+
+    // The suffix rules behind stem and stemLength.
+    static const SuffixStemmer& stemmer();
+
 };
 
 #endif // TEXTPROCESSOR_H
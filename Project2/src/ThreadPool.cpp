@@ -0,0 +1,116 @@
+#include "ThreadPool.h"       // Include the header file for the ThreadPool class
+#include <atomic>             // Include atomic for the shared chunk counter of parallelFor
+
+// Constructor: start the worker threads
+ThreadPool::ThreadPool(unsigned numThreads) : unfinished(0), stopping(false) {
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();  // May be 0 if unknown.
+    }
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    for (unsigned i = 0; i < numThreads; i++) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+// Destructor: finish outstanding work, then tell the workers to exit and join them
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+unsigned ThreadPool::size() const {
+    return (unsigned)workers.size();
+}
+
+// Each worker takes tasks off the queue until the pool shuts down
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (tasks.empty() && !stopping) {
+                taskAvailable.wait(lock);
+            }
+            if (tasks.empty()) {
+                return;           // Stopping and nothing left to do.
+            }
+            task = tasks.front();
+            tasks.pop_front();
+        }
+        task();                   // Run outside the lock so workers run in parallel.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            unfinished--;
+            if (unfinished == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+}
+
+// Queue a task and wake one worker
+void ThreadPool::submit(const std::function<void()>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+        unfinished++;
+    }
+    taskAvailable.notify_one();
+}
+
+// Block until the queue is empty and no task is running
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (unfinished != 0) {
+        allDone.wait(lock);
+    }
+}
+
+// Shared state of one parallelFor call. Its tasks capture only a reference to it, which
+// fits inside std::function's inline storage, so queueing them does not allocate.
+struct ParallelForState {
+    const std::function<void(size_t, size_t)>* body;
+    size_t count;
+    size_t grain;
+    std::atomic<size_t> next;     // start of the next unclaimed chunk
+};
+
+// Claim chunks of [0, count) one after another until none are left
+static void runChunks(ParallelForState& state) {
+    while (true) {
+        size_t begin = state.next.fetch_add(state.grain, std::memory_order_relaxed);
+        if (begin >= state.count) {
+            return;
+        }
+        size_t end = (state.count - begin > state.grain) ? begin + state.grain : state.count;
+        (*state.body)(begin, end);
+    }
+}
+
+// Split [0, count) into chunks, run them on the workers and wait for all of them.
+// One task per worker pulls chunks from a shared counter, rather than one task per chunk.
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (grain == 0) {
+        grain = 1;
+    }
+    ParallelForState state;
+    state.body = &body;
+    state.count = count;
+    state.grain = grain;
+    state.next.store(0, std::memory_order_relaxed);
+    size_t chunks = count / grain + (count % grain != 0 ? 1 : 0);
+    size_t taskCount = (chunks < workers.size()) ? chunks : workers.size();
+    for (size_t i = 0; i < taskCount; i++) {
+        submit([&state]() { runChunks(state); });
+    }
+    wait();
+}
@@ -0,0 +1,50 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads that run queued tasks.
+// The threads are started once and reused, so a caller that scores many batches
+// (e.g. SentimentClassifier::evaluate) does not pay thread start-up per batch.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()> > tasks;  // queued, not yet started
+    std::mutex mutex;
+    std::condition_variable taskAvailable;     // signalled when a task is queued or on shutdown
+    std::condition_variable allDone;           // signalled when the last running task finishes
+    size_t unfinished;                         // queued + running tasks
+    bool stopping;
+
+    void workerLoop();
+
+    // Not copyable.
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+public:
+    // Starts numThreads workers (0 = one per hardware thread).
+    explicit ThreadPool(unsigned numThreads = 0);
+
+    // Waits for queued tasks to finish, then stops the workers.
+    ~ThreadPool();
+
+    unsigned size() const;
+
+    // Queues a task for any worker.
+    void submit(const std::function<void()>& task);
+
+    // Blocks until every submitted task has finished.
+    void wait();
+
+    // Runs body(begin, end) over [0, count) split into chunks of at most 'grain' items,
+    // spread over the workers, and returns when all chunks are done.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+};
+
+#endif // THREADPOOL_H
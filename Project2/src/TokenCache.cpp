@@ -0,0 +1,28 @@
+#include "TokenCache.h"  // Include the header file for the TokenCache class
+
+// Allocate the table once; it never grows.
+TokenCache::TokenCache(size_t capacity) : mask(0) {
+    resize(capacity);
+}
+
+// Mark every entry empty (an empty entry matches no key, not even the empty one).
+void TokenCache::clear() {
+    for (size_t i = 0; i < entries.size(); i++) {
+        entries[i].hash = 0;
+        entries[i].length = EMPTY_LENGTH;
+    }
+}
+
+// Reallocate the table at the new size, rounded up to a power of two so a slot is hash & mask.
+void TokenCache::resize(size_t capacity) {
+    size_t slots = 0;
+    if (capacity > 0) {
+        slots = 1;
+        while (slots < capacity) {
+            slots *= 2;
+        }
+    }
+    std::vector<Entry>(slots).swap(entries);
+    mask = (slots > 0) ? slots - 1 : 0;
+    clear();
+}
@@ -0,0 +1,135 @@
+#ifndef TOKENCACHE_H
+#define TOKENCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "DSStringView.h"
+
+// Counters of a TokenCache (or several, added up).
+struct TokenCacheStats {
+    unsigned long long hits;      // lookups answered from the cache
+    unsigned long long misses;    // lookups of cacheable keys that were not there
+    unsigned long long uncached;  // lookups of keys too long to cache
+
+    TokenCacheStats() : hits(0), misses(0), uncached(0) {}
+
+    unsigned long long lookups() const { return hits + misses + uncached; }
+    double hitRate() const { return (lookups() > 0) ? (double)hits / lookups() : 0.0; }
+    void add(const TokenCacheStats& other) {
+        hits += other.hits;
+        misses += other.misses;
+        uncached += other.uncached;
+    }
+};
+
+// Bounded cache from raw token bytes (a word as it appears in the tweet, before
+// lowercasing, punctuation removal and stemming) to a 32-bit value, normally the term
+// ID the word normalizes to. Tweets repeat the same surface forms constantly, so most
+// words are answered by one hash and one compare instead of the whole normalization.
+// The cache is a direct-mapped table of fixed-size entries with the key stored inline:
+// a new key simply replaces whatever lived in its slot, memory never grows past the
+// capacity given at construction, and lookups never allocate. Keys longer than
+// MAX_KEY_LENGTH are not cached. Not thread-safe: use one cache per thread.
+class TokenCache {
+public:
+    static const size_t MAX_KEY_LENGTH = 23;
+    static const size_t DEFAULT_CAPACITY = 8192;
+private:
+    struct Entry {
+        uint32_t hash;
+        uint32_t value;
+        uint8_t length;                  // key length, or EMPTY_LENGTH
+        char key[MAX_KEY_LENGTH];
+    };
+    static const uint8_t EMPTY_LENGTH = 0xFF;
+
+    // True if the n (<= MAX_KEY_LENGTH) bytes at a and b are equal. Compares with a few
+    // fixed-size, possibly overlapping loads instead of a call to memcmp; no byte outside
+    // [0, n) is read.
+    static bool sameKey(const char* a, const char* b, size_t n) {
+        if (n >= 8) {
+            uint64_t x, y, xl, yl;
+            memcpy(&x, a, 8);
+            memcpy(&y, b, 8);
+            memcpy(&xl, a + n - 8, 8);
+            memcpy(&yl, b + n - 8, 8);
+            uint64_t diff = (x ^ y) | (xl ^ yl);
+            if (n > 16) {
+                memcpy(&x, a + 8, 8);
+                memcpy(&y, b + 8, 8);
+                diff |= x ^ y;
+            }
+            return diff == 0;
+        }
+        if (n >= 4) {
+            uint32_t x, y, xl, yl;
+            memcpy(&x, a, 4);
+            memcpy(&y, b, 4);
+            memcpy(&xl, a + n - 4, 4);
+            memcpy(&yl, b + n - 4, 4);
+            return ((x ^ y) | (xl ^ yl)) == 0;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<Entry> entries;          // a power of two of them (or none: caching disabled)
+    size_t mask;                         // entries.size() - 1
+    TokenCacheStats counters;
+public:
+    // A cache of 'capacity' entries, rounded up to a power of two; 0 disables caching.
+    explicit TokenCache(size_t capacity = DEFAULT_CAPACITY);
+
+    // Number of entries (0 if disabled).
+    size_t capacity() const { return entries.size(); }
+
+    // Finds the value stored for 'key'. Returns false on a miss.
+    bool lookup(const DSStringView& key, uint32_t& value) {
+        size_t length = key.length();
+        if (length > MAX_KEY_LENGTH || entries.empty()) {
+            counters.uncached++;
+            return false;
+        }
+        uint32_t h = key.hash();
+        const Entry& entry = entries[h & mask];
+        if (entry.hash == h && entry.length == length && sameKey(entry.key, key.data(), length)) {
+            counters.hits++;
+            value = entry.value;
+            return true;
+        }
+        counters.misses++;
+        return false;
+    }
+
+    // Stores 'value' for 'key', evicting the key that shared its slot. Long keys are ignored.
+    void insert(const DSStringView& key, uint32_t value) {
+        size_t length = key.length();
+        if (length > MAX_KEY_LENGTH || entries.empty()) {
+            return;
+        }
+        uint32_t h = key.hash();
+        Entry& entry = entries[h & mask];
+        entry.hash = h;
+        entry.value = value;
+        entry.length = (uint8_t)length;
+        memcpy(entry.key, key.data(), length);
+    }
+
+    // Forgets every entry (the counters are kept).
+    void clear();
+
+    // Changes the capacity (rounded up to a power of two; 0 disables), forgetting every entry.
+    void resize(size_t capacity);
+
+    // Hit and miss counts since construction or the last resetStats().
+    const TokenCacheStats& stats() const { return counters; }
+    void resetStats() { counters = TokenCacheStats(); }
+};
+
+#endif // TOKENCACHE_H
@@ -1,4 +1,6 @@
 #include "Tokenizer.h"  // Include the header file for the Tokenizer class
+#include "ByteScanner.h" // Include ByteScanner for the vectorized delimiter search
+#include <utility>      // Include utility for std::move
 
 // The tokenize function splits the given DSString 'str' into tokens separated by the specified 'delimiter' character.
 std::vector<DSString> Tokenizer::tokenize(const DSString& str, char delimiter) {
@@ -10,8 +12,8 @@ std::vector<DSString> Tokenizer::tokenize(const DSString& str, char delimiter) {
     // Loop through each character in the C-string representation of the input
     for (size_t i = 0; i < length; i++) {
         if (cstr[i] == delimiter) {        // Check if the current character is the delimiter
-            // When the delimiter is encountered, add the current token to the tokens vector
-            tokens.push_back(currentToken);
+            // When the delimiter is encountered, move the current token into the tokens vector
+            tokens.push_back(std::move(currentToken));
             // Reset currentToken to an empty DSString for the next token
             currentToken = DSString();
         } else {
@@ -20,7 +22,27 @@ std::vector<DSString> Tokenizer::tokenize(const DSString& str, char delimiter) {
         }
     }
     // After the loop, push the final token into the vector (even if it is empty)
-    tokens.push_back(currentToken);
+    tokens.push_back(std::move(currentToken));
     
     return tokens;  // Return the vector containing all the tokens
 }
+
+// View-based overload: splits 'str' on 'delimiter' into views that point into 'str'.
+// Produces exactly the same tokens as the DSString version, including empty ones.
+void Tokenizer::tokenize(const DSStringView& str, char delimiter, std::vector<DSStringView>& tokens) {
+    tokens.clear();                        // Reuse the caller's vector (keeps its capacity)
+    const char* cstr = str.data();         // Start of the characters to split
+    size_t length = str.length();          // Number of characters to split
+    size_t tokenStart = 0;                 // Index where the current token begins
+    while (true) {
+        // Jump straight to the next delimiter (vectorized search)
+        size_t i = tokenStart + ByteScanner::find(cstr + tokenStart, length - tokenStart, delimiter);
+        if (i == length) {
+            break;
+        }
+        tokens.push_back(DSStringView(cstr + tokenStart, i - tokenStart)); // End of a token: record a view of it
+        tokenStart = i + 1;                // The next token begins after the delimiter
+    }
+    // Push the final token (even if it is empty)
+    tokens.push_back(DSStringView(cstr + tokenStart, length - tokenStart));
+}
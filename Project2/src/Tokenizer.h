@@ -3,11 +3,16 @@
 
 #include <vector>
 #include "DSString.h"
+#include "DSStringView.h"
 
 class Tokenizer {
 public:
     // Splits the given DSString by the delimiter and returns a vector of tokens.
     static std::vector<DSString> tokenize(const DSString& str, char delimiter);
+
+    // Splits the given view by the delimiter into views of the same memory (no copies).
+    // 'tokens' is cleared first so callers can reuse one vector across many lines.
+    static void tokenize(const DSStringView& str, char delimiter, std::vector<DSStringView>& tokens);
 };
 
 #endif // TOKENIZER_H
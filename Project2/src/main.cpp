@@ -1,16 +1,184 @@
 #include <iostream>                     // Include the standard input/output stream library for console I/O
 #include <vector>                       // Include the vector library to use the std::vector container
+#include <cstring>                      // Include cstring for strcmp() to recognize the command name
+#include <csignal>                      // Include csignal to stop the scoring daemon on SIGINT / SIGTERM
 #include "DSString.h"                   // Include the header file for the custom DSString class
 #include "FileIO.h"                     // Include the header file for file input/output operations
 #include "Tokenizer.h"                  // Include the header file for the Tokenizer class
 #include "SentimentClassifier.h"        // Include the header file for the SentimentClassifier class
+#include "MappedFile.h"                 // Include the header file for mapping the new training tweets of "update"
+#include "ScoringServer.h"              // Include the header file for the Unix socket scoring daemon
+#include "StreamClassifier.h"           // Include the header file for stdin-to-stdout classification
+#include <unistd.h>                     // Include unistd.h for the standard input and output descriptors
 
 using namespace std;                    // Use the standard namespace to avoid prefixing std:: everywhere
 
+// Print the supported command lines.
+static void printUsage(const char* program) {
+    cout << "Usage: " << program
+         << " <training_data> <testing_data> <testing_sentiment> <results_file> <accuracy_file>" << endl
+         << "       " << program << " train <training_data> <model_file>" << endl
+         << "       " << program << " update <model_file> <new_training_data> <output_model_file>" << endl
+         << "       " << program
+         << " evaluate <model_file> <testing_data> <testing_sentiment> <results_file> <accuracy_file>" << endl
+         << "       " << program
+         << " evaluate-sorted <model_file> <testing_data> <testing_sentiment> <results_file> <accuracy_file>" << endl
+         << "       " << program << " serve <model_file> <socket_path>" << endl
+         << "       " << program << " classify <model_file> [--text] [--scores] < tweets > labels" << endl;
+}
+
+// "train" command: train on the training file and save the model for later runs.
+static int runTrain(char* argv[]) {
+    cout << "Training data file: " << argv[2] << endl;
+    cout << "Model output file: " << argv[3] << endl;
+
+    SentimentClassifier classifier;
+    if (!classifier.train(argv[2])) {
+        return 1;                    // train() has already reported the error
+    }
+    if (!classifier.save(argv[3])) {
+        return 1;                    // save() has already reported the error
+    }
+    cout << "Model saved." << endl;
+    return 0;
+}
+
+// "update" command: add new labeled tweets to a saved model without retraining on the old ones.
+static int runUpdate(char* argv[]) {
+    cout << "Model file: " << argv[2] << endl;
+    cout << "New training data file: " << argv[3] << endl;
+    cout << "Model output file: " << argv[4] << endl;
+
+    SentimentClassifier classifier;
+    if (!classifier.load(argv[2])) {
+        return 1;                    // load() has already reported the error
+    }
+    MappedFile trainingFile;
+    if (!trainingFile.open(argv[3])) {
+        return 1;                    // open() has already reported the error
+    }
+    // Every line is one labeled tweet, passed to update as a view into the mapping.
+    vector<DSStringView> lines;
+    DSStringView contents = trainingFile.view();
+    size_t offset = 0;
+    DSStringView line;
+    while (FileIO::nextLine(contents, offset, line)) {
+        lines.push_back(line);
+    }
+    classifier.update(lines);
+    if (!classifier.save(argv[4])) {
+        return 1;                    // save() has already reported the error
+    }
+    cout << "Model updated with " << lines.size() << " tweets." << endl;
+    return 0;
+}
+
+// "evaluate" command: load a saved model instead of retraining, then evaluate it.
+// "evaluate-sorted" does the same for test and ground-truth files sorted by tweet ID,
+// joining them in one streaming pass instead of loading the ground truth.
+static int runEvaluate(char* argv[], bool sorted) {
+    cout << "Model file: " << argv[2] << endl;
+    cout << "Testing data file: " << argv[3] << endl;
+    cout << "Testing sentiment file: " << argv[4] << endl;
+    cout << "Results output file: " << argv[5] << endl;
+    cout << "Accuracy output file: " << argv[6] << endl;
+
+    SentimentClassifier classifier;
+    if (!classifier.load(argv[2])) {
+        return 1;                    // load() has already reported the error
+    }
+    float accuracy = 0.0f;
+    if (sorted) {
+        if (!classifier.evaluateSorted(argv[3], argv[4], argv[5], argv[6], accuracy)) {
+            return 1;                // evaluateSorted() has already reported the error
+        }
+    } else {
+        accuracy = classifier.evaluate(argv[3], argv[4], argv[5], argv[6]);
+    }
+    cout << "Classifier Accuracy: " << accuracy << endl;
+    return 0;
+}
+
+// The running daemon, for the signal handler.
+static ScoringServer* activeServer = nullptr;
+
+static void stopServer(int) {
+    if (activeServer != nullptr) {
+        activeServer->stop();
+    }
+}
+
+// "serve" command: load a saved model once and answer scoring requests on a Unix socket
+// until interrupted (SIGINT or SIGTERM).
+static int runServe(char* argv[]) {
+    SentimentClassifier classifier;
+    if (!classifier.load(argv[2])) {
+        return 1;                    // load() has already reported the error
+    }
+    ScoringServer server(classifier);
+    if (!server.listen(argv[3])) {
+        return 1;                    // listen() has already reported the error
+    }
+    activeServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    cout << "Serving " << argv[2] << " on " << argv[3] << endl;
+    bool ok = server.run();
+    activeServer = nullptr;
+    cout << "Answered " << server.requestCount() << " requests (" << server.tweetCount() << " tweets)." << endl;
+    return ok ? 0 : 1;
+}
+
+// "classify" command: label the tweets read from standard input, writing "label,id" (or
+// "label,id,score" with --scores) lines to standard output. The input is CSV in the test
+// file's layout, or one tweet per line with --text. Messages go to standard error, so
+// standard output carries only the results.
+static int runClassify(int argc, char* argv[]) {
+    StreamClassifier::InputFormat format = StreamClassifier::INPUT_CSV;
+    bool withScores = false;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--text") == 0) {
+            format = StreamClassifier::INPUT_TEXT;
+        } else if (strcmp(argv[i], "--scores") == 0) {
+            withScores = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    SentimentClassifier classifier;
+    if (!classifier.load(argv[2])) {
+        return 1;                    // load() has already reported the error
+    }
+    StreamClassifier stream(classifier, format, withScores);
+    return stream.run(STDIN_FILENO, STDOUT_FILENO) ? 0 : 1;
+}
+
 // Main function: the entry point of the program.
 // It receives command-line arguments, which are used for file paths.
 int main(int argc, char* argv[]) {
-    // Check that the number of command-line arguments is exactly 6:
+    // Commands that split training and evaluation, so a trained model can be reused.
+    if (argc == 4 && strcmp(argv[1], "train") == 0) {
+        return runTrain(argv);
+    }
+    if (argc == 5 && strcmp(argv[1], "update") == 0) {
+        return runUpdate(argv);
+    }
+    if (argc == 7 && strcmp(argv[1], "evaluate") == 0) {
+        return runEvaluate(argv, false);
+    }
+    if (argc == 7 && strcmp(argv[1], "evaluate-sorted") == 0) {
+        return runEvaluate(argv, true);
+    }
+    if (argc == 4 && strcmp(argv[1], "serve") == 0) {
+        return runServe(argv);
+    }
+    if (argc >= 3 && argc <= 5 && strcmp(argv[1], "classify") == 0) {
+        return runClassify(argc, argv);
+    }
+
+    // Otherwise, check that the number of command-line arguments is exactly 6:
     // argv[0] is the program name, and argv[1] to argv[5] are the required arguments.
     // Expected arguments:
     // 1. Training data file
@@ -18,14 +186,12 @@ int main(int argc, char* argv[]) {
     // 3. Testing sentiment file (ground truth)
     // 4. Results output file
     // 5. Accuracy output file
-    if (argc != 6) {                 
+    if (argc != 6) {
         // If the number of arguments is incorrect, display the correct usage information.
-        cout << "Usage: " << argv[0] 
-             << " <training_data> <testing_data> <testing_sentiment> <results_file> <accuracy_file>" 
-             << endl;
+        printUsage(argv[0]);
         return 1;                    // Exit the program with an error code of 1
     }
-    
+
     // Display a message indicating the start of the sentiment analysis process.
     cout << "Starting Sentiment Analysis..." << endl;
     // Output the training data file path provided as the first argument.
@@ -38,17 +204,19 @@ int main(int argc, char* argv[]) {
     cout << "Results output file: " << argv[4] << endl;
     // Output the accuracy output file path provided as the fifth argument.
     cout << "Accuracy output file: " << argv[5] << endl;
-    
+
     // Create an instance of the SentimentClassifier class.
     SentimentClassifier classifier;
     // Train the classifier using the training data file (provided as argv[1]).
-    classifier.train(argv[1]);
-    
+    if (!classifier.train(argv[1])) {
+        return 1;                     // train() has already reported the error
+    }
+
     // Evaluate the classifier using the testing tweets file, testing sentiment file,
     // results output file, and accuracy output file (provided as argv[2] to argv[5]).
     float accuracy = classifier.evaluate(argv[2], argv[3], argv[4], argv[5]);
     // Output the classifier's accuracy to the console.
     cout << "Classifier Accuracy: " << accuracy << endl;
-    
+
     return 0;                         // Return 0 to indicate successful execution of the program.
 }